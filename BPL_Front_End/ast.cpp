@@ -0,0 +1,111 @@
+/*
+ * ast.cpp
+ * Flat syntax tree built by the BPL parser
+ * CS280
+ * Fall 2025
+ */
+
+#include <cstring>
+#include <cstdio>
+
+#include "ast.h"
+
+namespace {
+
+const char Magic[8] = { 'B', 'P', 'L', 'A', 'S', 'T', '0', '4' };
+
+//File layout: this header, then count AstNodes
+struct Header {
+	char	magic[8];
+	uint32_t	nodeSize;
+	uint32_t	root;
+	uint32_t	dialect;
+	uint32_t	unused;
+	uint64_t	sourceSize;
+	uint64_t	sourceHash;
+	uint64_t	count;
+};
+
+} // namespace
+
+uint32_t Ast::Add(NodeKind kind, const TokenView& tok)
+{
+	AstNode n;
+	n.kind = kind;
+	n.op = uint8_t(tok.kind);
+	n.parens = 0;
+	n.first = n.next = NoNode;
+	n.offset = tok.offset;
+	n.length = tok.length;
+	n.value = tok.number;
+	nodes.push_back(n);
+	return uint32_t(nodes.size() - 1);
+}
+
+bool Ast::Save(const string& path, const SourceBuffer& src, uint8_t dialect) const
+{
+	Header h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, Magic, sizeof(Magic));
+	h.nodeSize = sizeof(AstNode);
+	h.root = root;
+	h.dialect = dialect;
+	h.sourceSize = src.Size();
+	h.sourceHash = SourceHash(src.Begin(), src.Size());
+	h.count = nodes.size();
+
+	//written aside and renamed, so a reader sees the old tree or the new
+	string tmp = path + ".tmp";
+	FILE* f = fopen(tmp.c_str(), "wb");
+	if( !f )
+		return false;
+	bool ok = fwrite(&h, sizeof(h), 1, f) == 1
+		&& fwrite(nodes.data(), sizeof(AstNode), nodes.size(), f) == nodes.size();
+	ok = fclose(f) == 0 && ok;
+	if( ok && rename(tmp.c_str(), path.c_str()) == 0 )
+		return true;
+	remove(tmp.c_str());
+	return false;
+}
+
+bool Ast::Load(const string& path, const SourceBuffer& src, uint8_t dialect)
+{
+	FILE* f = fopen(path.c_str(), "rb");
+	if( !f )
+		return false;
+
+	Header h;
+	bool ok = fread(&h, sizeof(h), 1, f) == 1
+		&& memcmp(h.magic, Magic, sizeof(Magic)) == 0
+		&& h.nodeSize == sizeof(AstNode)
+		&& h.count > 0 && h.root < h.count
+		&& h.dialect == dialect
+		&& h.sourceSize == src.Size()
+		&& h.sourceHash == SourceHash(src.Begin(), src.Size());
+	if( ok ) {
+		nodes.resize(h.count);
+		ok = fread(nodes.data(), sizeof(AstNode), nodes.size(), f) == nodes.size()
+			&& fgetc(f) == EOF;
+	}
+	fclose(f);
+
+	//links and lexemes must stay inside the tree and the source; children
+	//are made before their parent and siblings in order, so following links
+	//cannot loop
+	for( size_t i = 0; ok && i < nodes.size(); i++ ) {
+		const AstNode& n = nodes[i];
+		size_t quote = n.kind == N_SCONST;
+		ok = n.kind <= N_SCONST
+			&& (n.first == NoNode || n.first < i)
+			&& (n.next == NoNode || (n.next > i && n.next < nodes.size()))
+			&& (n.offset == TokenView::NoOffset
+				|| (n.offset + quote <= src.Size() && n.length <= src.Size() - n.offset - quote));
+	}
+
+	if( !ok ) {
+		Clear();
+		return false;
+	}
+	root = h.root;
+	return true;
+}
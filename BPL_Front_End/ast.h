@@ -0,0 +1,85 @@
+/*
+ * ast.h
+ * Flat syntax tree built by the BPL parser
+ * CS280
+ * Fall 2025
+*/
+
+#ifndef AST_H_
+#define AST_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+#include "lex.h"
+
+enum NodeKind : uint8_t {
+	N_BLOCK,	// statements, in order
+	N_PRINTLN,	// the expressions to print
+	N_IF,		// condition, then block, optional else block
+	N_ASSIGN,	// variable, expression; op is the assignment operator
+	N_BINARY,	// left, right operand
+	N_UNARY,	// operand; op is '-', '+' or '!'
+	N_IDENT,
+	N_ICONST,
+	N_FCONST,
+	N_SCONST,
+};
+
+//Nodes refer to each other by index, never by pointer, so the tree is one
+//block of memory that can be written out and read back as it is. A node's
+//children are first, first's next, and so on.
+struct AstNode {
+	uint8_t	kind;	// NodeKind
+	uint8_t	op;	// Token the node was made from
+	uint16_t	parens;	// pairs of parentheses written around the node
+	uint32_t	first;	// first child, or Ast::NoNode
+	uint32_t	next;	// next sibling, or Ast::NoNode
+	uint32_t	offset;	// of the token in the source; TokenView::NoOffset for a block
+	uint32_t	length;	// of its lexeme, which skips an SCONST's quote
+	double	value;	// an ICONST's or FCONST's number, as its token carried it
+};
+
+//The tree of one parse. The node vector is the parse's arena: nodes are
+//appended as rules succeed, and Clear keeps the storage for the next parse.
+//Leaves hold offsets, not text, so the tree is read together with the
+//source it was parsed from; Save and Load check that it is the same one.
+//In a sign applied to a power, as in -2 ** 2, the N_UNARY holds just the
+//base, the way the interpreter evaluates it; '!' holds the whole power.
+class Ast {
+	vector<AstNode>	nodes;
+	uint32_t	root;
+
+public:
+	static const uint32_t NoNode = ~0u;
+
+	Ast() : root(NoNode) {}
+
+	void	Clear() { nodes.clear(); root = NoNode; }
+	uint32_t	Add(NodeKind kind, const TokenView& tok);
+
+	uint32_t	Root() const { return root; }
+	void	SetRoot(uint32_t n) { root = n; }
+	size_t	Size() const { return nodes.size(); }
+	const AstNode&	operator[](uint32_t n) const { return nodes[n]; }
+	AstNode&	operator[](uint32_t n) { return nodes[n]; }
+
+	//Lexeme of a node, read from the source the tree was parsed from
+	string_view	Text(uint32_t n, const char* source) const {
+		const AstNode& a = nodes[n];
+		return string_view(source + a.offset + (a.kind == N_SCONST), a.length);
+	}
+
+	//False if path cannot be written. dialect is the parser's Dialect the
+	//tree was parsed in: the dialects accept different programs
+	bool	Save(const string& path, const SourceBuffer& src, uint8_t dialect) const;
+	//False if path is missing, damaged, or was made from another source or
+	//in another dialect
+	bool	Load(const string& path, const SourceBuffer& src, uint8_t dialect);
+};
+
+#endif /* AST_H_ */
@@ -0,0 +1,770 @@
+/*
+ * lex.cpp
+ *
+ * CS280 - Fall 2025
+ * Lexical Analyzer for the Basic Perl-Like (BPL) Language
+ */
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+#include "lex.h"
+#include "scan.h"
+
+double ParseNumber(string_view lexeme)
+{
+	double v = 0;
+	from_chars_result r = from_chars(lexeme.data(), lexeme.data() + lexeme.size(), v);
+	//stod threw here; give the overflowed or underflowed value instead
+	if( r.ec == errc::result_out_of_range )
+		v = strtod(string(lexeme).c_str(), nullptr);
+	return v;
+}
+
+uint64_t SourceHash(const char* p, size_t n)
+{
+	uint64_t h = 14695981039346656037ull;
+	size_t i = 0;
+	for( ; i + 8 <= n; i += 8 ) {
+		uint64_t w;
+		memcpy(&w, p + i, 8);
+		h = (h ^ w) * 1099511628211ull;
+	}
+	for( ; i < n; i++ )
+		h = (h ^ (unsigned char)p[i]) * 1099511628211ull;
+	return h;
+}
+
+static_assert(KeywordToken("PrintLn") == PRINTLN && KeywordToken("ELSE") == ELSE
+	&& KeywordToken("iF") == IF && KeywordToken("ifx") == IDENT && KeywordToken("$if") == IDENT,
+	"keyword recognition");
+
+LexItem id_or_kw(const string& lexeme , int linenum)
+{
+	return LexItem(KeywordToken(lexeme), lexeme, linenum);
+}
+
+//Token names, in the order of enum Token
+static constexpr const char* tokenPrint[] = {
+	"PRINTLN", "IF", "ELSE",
+	"IDENT",
+	"ICONST", "FCONST", "SCONST",
+	"PLUS", "MINUS", "MULT", "DIV", "REM", "EXPONENT", "NEQ", "SEQ", "NLT", "NGTE",
+	"SLTE", "SGT", "CAT", "SREPEAT", "AND", "OR", "NOT", "ASSOP", "CADDA", "CSUBA", "CCATA",
+	"COMMA", "SEMICOL", "LPAREN", "RPAREN", "LBRACES", "RBRACES",
+	"ERR",
+	"DONE",
+};
+
+static_assert(sizeof(tokenPrint) / sizeof(tokenPrint[0]) == DONE + 1, "tokenPrint must name every Token");
+
+ostream& operator<<(ostream& out, const LexItem& tok) {
+	
+	Token tt = tok.GetToken() ;
+	out << tokenPrint[ tt ] << ": ";
+	if( tt == IDENT ) 
+		out << "(" << tok.GetLexeme() << ")";
+	else if (tt == ICONST || tt == FCONST ) {
+		out << "[" << tok.GetLexeme() << "]";
+	}
+	else if (tt == SCONST)
+	{
+		out << "<" << tok.GetLexeme() << ">";
+	}
+	else if (tt == ERR)
+	{
+		int line = tok.GetLinenum() + 1;
+		out << "Error-Unrecognized Lexeme {" << tok.GetLexeme() << "} in line " << line;
+	}
+	else
+	{
+		out << "\"" << tok.GetLexeme() << "\"";
+	}
+	return out;
+}
+
+SourceBuffer::SourceBuffer() : data(""), size(0), mapping(nullptr), stream(&buf)
+{
+	Adopt();
+}
+
+SourceBuffer::~SourceBuffer()
+{
+	if( mapping )
+		munmap(mapping, size);
+}
+
+void SourceBuffer::Adopt()
+{
+	buf.Set(data, data + size);
+	stream.clear();
+	lines.Build(data, data + size);
+}
+
+void LineTable::Build(const char* b, const char* e)
+{
+	starts.clear();
+	if( (size_t)(e - b) >= TokenView::NoOffset )
+	{
+		begin = nullptr;
+		return;
+	}
+	begin = b;
+	starts.reserve((e - b) / 32 + 1);
+	starts.push_back(0);
+	scan::LineStarts(b, e, b, starts);
+}
+
+void LineTable::Replace(const char* b, const char* e, size_t offset, size_t removed, size_t inserted)
+{
+	if( !Built() || (size_t)(e - b) >= TokenView::NoOffset )
+	{
+		Build(b, e);
+		return;
+	}
+	begin = b;
+
+	//lines that started inside the removed bytes go, the rest move
+	auto lo = upper_bound(starts.begin(), starts.end(), offset);
+	auto hi = upper_bound(lo, starts.end(), offset + removed);
+	for( auto it = hi; it != starts.end(); ++it )
+		*it = unsigned(*it + inserted - removed);
+
+	vector<unsigned> added;
+	scan::LineStarts(b + offset, b + offset + inserted, b, added);
+	if( added.size() <= size_t(hi - lo) )
+		starts.erase(copy(added.begin(), added.end(), lo), hi);
+	else
+	{
+		size_t at = lo - starts.begin() + (hi - lo);
+		copy(added.begin(), added.begin() + (hi - lo), lo);
+		starts.insert(starts.begin() + at, added.begin() + (hi - lo), added.end());
+	}
+}
+
+int LineTable::Line(size_t offset) const
+{
+	return int(upper_bound(starts.begin(), starts.end(), offset) - starts.begin());
+}
+
+int LineTable::Column(size_t offset) const
+{
+	return int(offset - starts[Line(offset) - 1]) + 1;
+}
+
+bool SourceBuffer::OpenFile(const string& path)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if( fd < 0 )
+		return false;
+
+	struct stat st;
+	if( fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 )
+	{
+		void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if( p != MAP_FAILED )
+		{
+			close(fd);
+			madvise(p, st.st_size, MADV_SEQUENTIAL);
+			mapping = p;
+			data = (const char*)p;
+			size = st.st_size;
+			Adopt();
+			return true;
+		}
+	}
+
+	//not mappable (empty file, pipe, device): read it all
+	char block[65536];
+	ssize_t n;
+	while( (n = read(fd, block, sizeof(block))) > 0 )
+		copy.append(block, n);
+	close(fd);
+	if( n < 0 )
+		return false;
+	data = copy.data();
+	size = copy.size();
+	Adopt();
+	return true;
+}
+
+void SourceBuffer::ReadStream(istream& in)
+{
+	SetText(string((istreambuf_iterator<char>(in)), istreambuf_iterator<char>()));
+}
+
+void SourceBuffer::SetText(const string& text)
+{
+	if( mapping )
+	{
+		munmap(mapping, size);
+		mapping = nullptr;
+	}
+	copy = text;
+	data = copy.data();
+	size = copy.size();
+	Adopt();
+}
+
+BlockReader::BlockReader(int fd, size_t block)
+	: fd(fd), block(block), pos(0), keep(0), dropped(0), atEnd(false), failed(false)
+{
+}
+
+bool BlockReader::Fill()
+{
+	if( atEnd )
+		return false;
+
+	if( keep > 0 )
+	{
+		buf.erase(0, keep);
+		pos -= keep;
+		dropped += keep;
+		keep = 0;
+	}
+
+	if( beforeRead )
+		beforeRead();
+
+	size_t old = buf.size();
+	buf.resize(old + block);
+	ssize_t n;
+	do {
+		n = read(fd, &buf[old], block);
+	} while( n < 0 && errno == EINTR );
+
+	buf.resize(old + (n > 0 ? n : 0));
+	if( n <= 0 )
+	{
+		atEnd = true;
+		failed = n < 0;
+		return false;
+	}
+	return true;
+}
+
+//Character sources for LexToken. Each offers get/peek/unget like an istream;
+//start/add record the lexeme as it is scanned. The skip and scan calls
+//consume a whole run of one character class at once where the source holds
+//the bytes in memory, and do nothing otherwise.
+
+//Reads an istream and builds each lexeme as an owned string
+class StreamSource {
+	istream& in;
+	string lexeme;
+
+public:
+	typedef LexItem Item;
+
+	StreamSource(istream& in) : in(in) {}
+
+	bool get(char& ch) { return (bool)in.get(ch); }
+	int peek() { return in.peek(); }
+	void unget(char ch) { in.putback(ch); }
+	bool eof() const { return in.eof(); }
+
+	void start(char ch) { lexeme = ch; }
+	void add(char ch) { lexeme += ch; }
+
+	void skipSpace(int&) {}
+	void skipComment() {}
+	void scanIdent() {}
+	void scanDigits() {}
+	void scanString(char) {}
+
+	LexItem make(Token tt, int line) { return LexItem(tt, lexeme, line); }
+	LexItem makeQuoted(Token tt, int line) {
+		return LexItem(tt, lexeme.substr(1, lexeme.length()-2), line);
+	}
+	LexItem ident(int line) { return id_or_kw(lexeme, line); }
+	LexItem done(int line) { return LexItem(DONE, "", line); }
+	LexItem fail(int line) { return LexItem(ERR, "some strange I/O error", line); }
+};
+
+//Reads a SourceCursor; every lexeme is a contiguous run of the buffer, so
+//tokens are views of it
+class BufferSource {
+	SourceCursor& src;
+	const char* tok;
+	const char* tokEnd;
+
+	unsigned at(const char* p) const { return unsigned(p - src.beg); }
+
+public:
+	typedef TokenView Item;
+
+	BufferSource(SourceCursor& src) : src(src), tok(src.cur), tokEnd(src.cur) {}
+
+	bool get(char& ch) {
+		if( src.cur == src.end ) return false;
+		ch = *src.cur++;
+		return true;
+	}
+	int peek() { return src.cur < src.end ? (unsigned char)*src.cur : EOF; }
+	void unget(char) { --src.cur; }
+	bool eof() const { return true; }
+
+	void start(char) { tok = src.cur - 1; tokEnd = src.cur; }
+	void add(char) { tokEnd = src.cur; }
+
+	void skipSpace(int& linenum) { src.cur = scan::SkipSpace(src.cur, src.end, linenum); }
+	void skipComment() { src.cur = scan::FindByte(src.cur, src.end, '\n', '\n', '\n'); }
+	void scanIdent() { tokEnd = src.cur = scan::SkipIdent(src.cur, src.end); }
+	void scanDigits() { tokEnd = src.cur = scan::SkipDigits(src.cur, src.end); }
+	void scanString(char quote) { tokEnd = src.cur = scan::FindByte(src.cur, src.end, quote, '\n', quote); }
+
+	TokenView make(Token tt, int) { return TokenView(tt, at(tok), tok, tokEnd - tok); }
+	TokenView makeQuoted(Token tt, int) { return TokenView(tt, at(tok), tok + 1, tokEnd - tok - 2); }
+	TokenView ident(int) {
+		return TokenView(KeywordToken(string_view(tok, tokEnd - tok)), at(tok), tok, tokEnd - tok);
+	}
+	TokenView done(int) { return TokenView(DONE, at(src.cur), 0, 0.0); }
+	TokenView fail(int) { return TokenView(ERR, at(src.cur), 0, 0.0); }
+};
+
+//Reads a BlockReader; the buffer moves on refill, so lexemes are copied out
+class ReaderSource {
+	BlockReader& rd;
+	size_t tokEnd;
+	bool inTok;
+
+	//offset in the whole input of the byte at i in the buffer
+	unsigned at(size_t i) const { return unsigned(rd.dropped + i); }
+
+	bool more() {
+		if( rd.pos < rd.buf.size() ) return true;
+		if( !inTok ) rd.keep = rd.pos;
+		size_t shift = rd.keep;
+		if( !rd.Fill() ) return false;
+		tokEnd -= shift;
+		return true;
+	}
+
+public:
+	typedef LexItem Item;
+
+	ReaderSource(BlockReader& rd) : rd(rd), tokEnd(rd.pos), inTok(false) { rd.keep = rd.pos; }
+
+	bool get(char& ch) {
+		if( !more() ) return false;
+		ch = rd.buf[rd.pos++];
+		return true;
+	}
+	int peek() { return more() ? (unsigned char)rd.buf[rd.pos] : EOF; }
+	void unget(char) { --rd.pos; }
+	bool eof() const { return !rd.failed; }
+
+	void start(char) { rd.keep = rd.pos - 1; tokEnd = rd.pos; inTok = true; }
+	void add(char) { tokEnd = rd.pos; }
+
+	//these only look at what is buffered; get() refills for the rest
+	void skipSpace(int& linenum) {
+		const char* b = rd.buf.data();
+		rd.pos = scan::SkipSpace(b + rd.pos, b + rd.buf.size(), linenum) - b;
+	}
+	void skipComment() {
+		const char* b = rd.buf.data();
+		rd.pos = scan::FindByte(b + rd.pos, b + rd.buf.size(), '\n', '\n', '\n') - b;
+		inTok = false;	// a comment has no lexeme to keep
+	}
+	void scanIdent() {
+		const char* b = rd.buf.data();
+		tokEnd = rd.pos = scan::SkipIdent(b + rd.pos, b + rd.buf.size()) - b;
+	}
+	void scanDigits() {
+		const char* b = rd.buf.data();
+		tokEnd = rd.pos = scan::SkipDigits(b + rd.pos, b + rd.buf.size()) - b;
+	}
+	void scanString(char quote) {
+		const char* b = rd.buf.data();
+		tokEnd = rd.pos = scan::FindByte(b + rd.pos, b + rd.buf.size(), quote, '\n', quote) - b;
+	}
+
+	LexItem make(Token tt, int line) {
+		return LexItem(tt, rd.buf.substr(rd.keep, tokEnd - rd.keep), line, at(rd.keep));
+	}
+	LexItem makeQuoted(Token tt, int line) {
+		return LexItem(tt, rd.buf.substr(rd.keep + 1, tokEnd - rd.keep - 2), line, at(rd.keep));
+	}
+	LexItem ident(int line) {
+		string lexeme = rd.buf.substr(rd.keep, tokEnd - rd.keep);
+		return LexItem(KeywordToken(lexeme), lexeme, line, at(rd.keep));
+	}
+	LexItem done(int line) { return LexItem(DONE, "", line, at(rd.pos)); }
+	LexItem fail(int line) { return LexItem(ERR, "some strange I/O error", line, at(rd.pos)); }
+};
+
+template <class Src>
+static typename Src::Item LexToken(Src& in, int& linenum)
+{
+	enum TokState { START, INID, INSQSTR, INDQSTR, ININT, INFLOAT, INCOMMENT, INSCOMPARE } lexstate = START;
+	char ch, nextch, nextchar;
+	Token tt;
+	bool dec = false;
+	       
+	while(in.get(ch)) {
+    	
+		switch( lexstate ) {
+		case START:
+			if( ch == '\n' )
+			{
+				linenum++;
+			}	
+                
+			if( isspace(ch) ) {
+				in.skipSpace(linenum);
+				continue;
+			}
+
+			in.start(ch);
+
+			if( isalpha(ch) || ch == '$') {
+				lexstate = INID;
+				
+			}
+				
+			else if( ch == '\''  ) {
+				lexstate = INSQSTR;
+			}
+			else if(ch == '\"') 
+			{
+				lexstate = INDQSTR;
+			}
+			else if( isdigit(ch) ) {
+				lexstate = ININT;
+			}
+			else if( ch == '#' ) {
+				lexstate = INCOMMENT;
+			}
+			else if( ch == '@' ) {
+				lexstate = INSCOMPARE;
+			}			
+			else {
+				tt = ERR;
+				switch( ch ) {
+				case '+':
+					tt = PLUS;
+					nextchar = in.peek();
+					if(nextchar == '=' ){
+						in.get(ch);
+						in.add(ch);
+						tt = CADDA;
+					}
+                    break;  
+					
+				case '-':
+					tt = MINUS;
+					nextchar = in.peek();
+					if(nextchar == '=' ){
+						in.get(ch);
+						in.add(ch);
+						tt = CSUBA;
+					}
+                    break; 
+					
+				case '*':
+					tt = MULT;
+					nextchar = in.peek();
+					if(nextchar == '*'){
+						in.get(ch);
+						in.add(ch);
+						tt = EXPONENT;
+						
+					}
+					break;
+
+				case '/':
+					tt = DIV;
+					break;
+				case '%':
+					tt = REM;
+					break;	
+					
+				case '=':
+					tt = ASSOP;
+					nextchar = in.peek();
+					if(nextchar == '='){
+						in.get(ch);
+						in.add(ch);
+						tt = NEQ;
+						
+					}
+					
+					break;
+				
+				case '(':
+					tt = LPAREN;
+					break;			
+				case ')':
+					tt = RPAREN;
+					break;
+				case '{':
+					tt = LBRACES;
+					break;			
+				case '}':
+					tt = RBRACES;
+					break;
+				case ';':
+					tt = SEMICOL;
+					break;
+					
+				case ',':
+					tt = COMMA;
+					break;
+					
+				case '>':
+					nextchar = in.peek();
+					if(nextchar == '='){
+						in.get(ch);
+						in.add(ch);
+						tt = NGTE;
+						
+					}
+					else
+					{
+						tt = ERR;
+					}
+					break;
+				
+				case '<':
+					tt = NLT;
+					break;
+				case '!':
+					tt = NOT;
+					break;	
+				
+				case '&':
+					nextchar = in.peek();
+					if(nextchar == '&'){
+						in.get(ch);
+						in.add(ch);
+						tt = AND;	
+					}
+					else
+					{
+						tt = ERR;
+					}
+					break;
+				
+				case '|':
+					nextchar = in.peek();
+					if(nextchar == '|'){
+						in.get(ch);
+						in.add(ch);
+						tt = OR;	
+					}
+					else
+					{
+						tt = ERR;
+					}
+					break;
+							
+				case '.':
+					tt = CAT;
+					nextchar = in.peek();
+					if(nextchar == '=' ){
+						in.get(ch);
+						in.add(ch);
+						tt = CCATA;
+						
+					}
+					else if (nextchar == 'x') {
+						in.get(ch);
+						in.add(ch);
+						nextchar = in.peek();
+						if(nextchar == '.')
+						{
+							in.get(ch);
+							in.add(ch);
+							tt = SREPEAT;
+							
+						}
+						else
+						{
+							tt = ERR;
+							
+						}
+					}
+					
+					break;
+				}
+				return in.make(tt, linenum);
+			}
+			break;	//from START
+
+		case INID:
+			
+			if( isalpha(ch) || isdigit(ch) || (ch == '_' ) || (ch == '$' )) {
+							
+				in.add(ch);
+				in.scanIdent();
+			}
+			else {
+				in.unget(ch);
+				return in.ident(linenum);
+			}
+			break;//from INID
+			
+		case INSQSTR:
+                          
+			if( ch == '\n' ) {
+				return in.make(ERR, linenum);
+			}
+			in.add(ch);
+			if( ch == '\'' ) {
+				return in.makeQuoted(SCONST, linenum);
+			}
+			in.scanString('\'');
+			break;//from INSQSTR
+		case INDQSTR:
+                          
+			if( ch == '\n' ) {
+				return in.make(ERR, linenum);
+			}
+			in.add(ch);
+			if( ch == '\"' ) {
+				return in.makeQuoted(SCONST, linenum);
+			}
+			in.scanString('\"');
+			break;//from INDQSTR
+			
+		case ININT:
+			if( isdigit(ch) ) {
+				in.add(ch);
+				in.scanDigits();
+			}
+			else if(ch == '.') {
+				lexstate = INFLOAT;
+				in.unget(ch);
+			}
+			else {
+				in.unget(ch);
+				return in.make(ICONST, linenum);
+			}
+			break;//from ININT
+		
+		case INFLOAT:
+				
+			if( ch ==  '.' && isdigit(in.peek()) && !dec) {
+				in.add(ch);
+				in.get(ch);
+				in.add(ch); 
+				dec = true;
+			}
+			else if(isdigit(ch) && dec)
+			{
+				in.add(ch);
+				in.scanDigits();
+			}
+			else if(( ch == 'E' || ch == 'e' ) && dec ){
+				nextch = in.peek();
+				if(nextch == '+' || nextch == '-' || isdigit(nextch))
+				{
+					in.add(ch);
+					in.get(ch);
+					in.add(ch);
+					
+				}
+				else
+				{
+					in.unget(ch);//put back E character
+					return in.make(FCONST, linenum);
+				}
+			}
+			else if((ch == '.') && dec && isdigit(in.peek())){
+				in.add(ch);
+				
+				return in.make(ERR, linenum);
+			}
+			else {
+				in.unget(ch);
+				
+				return in.make(FCONST, linenum);
+			}
+			
+			break;//from INFLOAT
+			
+		case INCOMMENT:
+			if(ch == '\n') {
+				linenum++;
+				
+				lexstate = START;
+			}
+			else {
+				in.skipComment();
+			}
+			break;//from INCOMMENT
+			
+		case INSCOMPARE:
+			char currentch = tolower(ch);
+			
+			nextchar = in.peek();
+			nextchar = tolower(nextchar);
+			if(currentch == 'e' && nextchar == 'q')
+			{
+				in.add(ch);
+				in.get(ch);
+				currentch = tolower(ch);
+				in.add(ch);
+				return in.make(SEQ, linenum);
+			}
+			else if(currentch == 'g' && nextchar == 't')
+			{
+				in.add(ch);
+				in.get(ch);
+				currentch = tolower(ch);
+				in.add(ch);
+				return in.make(SGT, linenum);
+			}
+			else if(currentch == 'l' && nextchar == 'e')
+			{
+				in.add(ch);
+				in.get(ch);
+				currentch = tolower(ch);
+				in.add(ch);
+				return in.make(SLTE, linenum);
+			}
+			else
+			{
+				return in.make(ERR, linenum);
+			}
+			break;//from INSCOMPARE
+		}
+	
+	}//end of while loop
+	
+	if( in.eof() )
+		return in.done(linenum);
+		
+	return in.fail(linenum);
+}
+
+
+LexItem getNextToken(istream& in, int& linenum)
+{
+	StreamSource src(in);
+	return LexToken(src, linenum);
+}
+
+TokenView getNextTokenLegacy(SourceCursor& cursor, int& linenum)
+{
+	BufferSource src(cursor);
+	return LexToken(src, linenum);
+}
+
+LexItem getNextToken(BlockReader& reader, int& linenum)
+{
+	ReaderSource src(reader);
+	return LexToken(src, linenum);
+}
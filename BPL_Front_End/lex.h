@@ -0,0 +1,324 @@
+/*
+ * lex.h
+ * Lexical Analyzer for the Basic Perl-Like (BPL) Language
+ * CS280
+ * Fall 2025
+*/
+
+#ifndef LEX_H_
+#define LEX_H_
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <type_traits>
+using namespace std;
+
+
+//Definition of all the possible token types
+enum Token {
+	// keywords
+	PRINTLN, IF, ELSE, 
+	// identifiers
+	IDENT, 
+	// an integer, real, and string constant
+	ICONST, FCONST, SCONST, 
+	// the numeric operators, assignment, numeric and string comparison operators
+	PLUS, MINUS, MULT, DIV, REM, EXPONENT, NEQ, SEQ, NLT, NGTE,
+	SLTE, SGT, CAT, SREPEAT, AND, OR, NOT, ASSOP, CADDA, CSUBA, CCATA,
+	//Delimiters
+	COMMA, SEMICOL, LPAREN, RPAREN, LBRACES, RBRACES, 
+	// any error returns this token
+	ERR,
+	// when completed (EOF), return this token
+	DONE,
+};
+
+
+//Value of an ICONST or FCONST lexeme, the same as stod gives
+extern double ParseNumber(string_view lexeme);
+
+//FNV-1a over 8-byte words of a source; files derived from a source keep it
+//to tell when they are stale
+extern uint64_t SourceHash(const char* p, size_t n);
+
+//A token read from a buffer in memory, kept by value: its kind, the offset
+//of its first byte in the buffer, quote included, and the length of its
+//lexeme, which for a string is what is between the quotes. The lexeme is
+//read back from the buffer, which must outlive the token. Numeric constants
+//carry their value, parsed once when the token is made.
+struct TokenView {
+	static const unsigned NoOffset = ~0u;
+
+	Token	kind;
+	unsigned	offset;
+	unsigned	length;
+	double	number;
+
+	TokenView() : kind(ERR), offset(NoOffset), length(0), number(0) {}
+	TokenView(Token kind, unsigned at, const char* lex, size_t len)
+		: kind(kind), offset(at), length(unsigned(len)),
+		  number((kind == ICONST || kind == FCONST) ? ParseNumber(string_view(lex, len)) : 0) {}
+	//for a token whose number was parsed before
+	TokenView(Token kind, unsigned at, size_t len, double value)
+		: kind(kind), offset(at), length(unsigned(len)), number(value) {}
+
+	bool operator==(const Token k) const { return kind == k; }
+	bool operator!=(const Token k) const { return kind != k; }
+
+	//Lexeme of the token in the buffer that starts at text
+	string_view	Lexeme(const char* text) const {
+		return string_view(text + offset + (kind == SCONST), length);
+	}
+	//True if this ERR token took the newline after it along: a string cut
+	//off by the end of its line does, and so does an '@' before one. The
+	//lexers never count that newline, so every line after it is one less
+	//than the line table says.
+	bool	SwallowsNewline(const char* text) const {
+		if( kind != ERR )
+			return false;
+		const char* p = text + offset;
+		return (*p == '\'' || *p == '"' || *p == '@') && p[length] == '\n';
+	}
+};
+static_assert(is_trivially_copyable<TokenView>::value, "tokens are copied as bytes");
+
+//Class definition of LexItem
+//A token read from a stream owns its lexeme and carries its line. Tokens a
+//PushLexer or a BlockReader makes also carry the offset of their first byte
+//in the whole input. Numeric constants carry their value, parsed once when the token is
+//made.
+class LexItem {
+	Token	token;
+	int	lnum;
+	string	lexeme;
+	unsigned	offset;
+	double	num;
+
+public:
+	static const unsigned NoOffset = TokenView::NoOffset;
+
+	LexItem() {
+		token = ERR;
+		offset = NoOffset;
+		lnum = -1;
+		num = 0;
+	}
+	LexItem(Token token, string lexeme, int line, unsigned at = NoOffset) {
+		this->token = token;
+		this->lexeme = lexeme;
+		this->offset = at;
+		this->lnum = line;
+		this->num = (token == ICONST || token == FCONST) ? ParseNumber(this->lexeme) : 0;
+	}
+
+	bool operator==(const Token token) const { return this->token == token; }
+	bool operator!=(const Token token) const { return this->token != token; }
+
+	Token	GetToken() const { return token; }
+	string	GetLexeme() const { return lexeme; }
+	string_view	GetLexemeView() const { return lexeme; }
+	int	GetLinenum() const { return lnum; }
+	double	GetNumber() const { return num; }
+	unsigned	GetOffset() const { return offset; }
+};
+
+
+//Where every line of a source starts, found in one pass over it. Tokens
+//lexed from memory carry only their offset, and their line is looked up here
+//when something reports it, as their column is. Offsets are 32-bit, so a
+//source of 4 GiB or more gets no table.
+class LineTable {
+	const char*	begin;
+	vector<unsigned>	starts;	// offset of the first byte of each line
+
+public:
+	LineTable() : begin(nullptr) {}
+
+	void	Build(const char* b, const char* e);
+	//Follows an edit of the text: removed bytes at offset became the
+	//inserted ones, and the whole text is now [b, e)
+	void	Replace(const char* b, const char* e, size_t offset, size_t removed, size_t inserted);
+	bool	Built() const { return begin != nullptr; }
+	const char*	Begin() const { return begin; }
+	size_t	Lines() const { return starts.size(); }
+
+	//Line of the byte at offset, counting from 1
+	int	Line(size_t offset) const;
+	//The same for offsets that only grow; hint is where the last one was
+	int	Line(size_t offset, size_t& hint) const {
+		while( hint + 1 < starts.size() && starts[hint + 1] <= offset )
+			hint++;
+		return int(hint) + 1;
+	}
+	//Column of the byte at offset, counting from 1
+	int	Column(size_t offset) const;
+};
+
+
+//Whole program text held in memory: a read-only mapping of the file when
+//possible, otherwise a copy. Stream() reads the same bytes as an istream.
+class SourceBuffer {
+	class MemBuf : public streambuf {
+	public:
+		void Set(const char* b, const char* e) { setg((char*)b, (char*)b, (char*)e); }
+	};
+
+	const char*	data;
+	size_t	size;
+	void*	mapping;
+	string	copy;
+	MemBuf	buf;
+	istream	stream;
+	LineTable	lines;
+
+	void Adopt();
+
+public:
+	SourceBuffer();
+	~SourceBuffer();
+	SourceBuffer(const SourceBuffer&) = delete;
+	SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+	bool	OpenFile(const string& path);
+	void	ReadStream(istream& in);
+	void	SetText(const string& text);
+
+	const char*	Begin() const { return data; }
+	const char*	End() const { return data + size; }
+	size_t	Size() const { return size; }
+	istream&	Stream() { return stream; }
+	const LineTable*	Lines() const { return lines.Built() ? &lines : nullptr; }
+};
+
+//Read position in a SourceBuffer, or in any [begin, end) range of one.
+//Token offsets are from beg. The lexer keeps no line; lines, numbered from
+//1 at the table's start, are looked up in lines when they are needed.
+struct SourceCursor {
+	const char*	beg;
+	const char*	cur;
+	const char*	end;
+	const LineTable*	lines;	// null: count newlines from beg instead
+
+	SourceCursor(const SourceBuffer& src)
+		: beg(src.Begin()), cur(src.Begin()), end(src.End()), lines(src.Lines()) {}
+	SourceCursor(const char* b, const char* e, const LineTable* table = nullptr)
+		: beg(b), cur(b), end(e), lines(table) {}
+
+	size_t	Offset() const { return cur - beg; }
+};
+
+
+//Refillable window over a file descriptor, for input that cannot be mapped
+//(pipes, stdin). The lexer reads it a block at a time with read(2); the
+//bytes of a token that straddles a block boundary are kept across refills.
+class BlockReader {
+	int	fd;
+	size_t	block;
+	string	buf;
+	size_t	pos;	// next byte for the lexer
+	size_t	keep;	// first byte the lexer still needs
+	size_t	dropped;	// bytes of input erased from the front of buf
+	bool	atEnd;
+	bool	failed;
+
+	friend class ReaderSource;
+
+public:
+	explicit BlockReader(int fd, size_t block = 65536);
+
+	//Called before each read, which may block; a lexer on its own thread
+	//uses it to hand over the tokens it has before waiting for more input
+	function<void()>	beforeRead;
+
+	//Drops bytes before keep and appends the next block; false at end of input
+	bool	Fill();
+	size_t	Buffered() const { return buf.size() - pos; }
+	bool	Failed() const { return failed; }
+};
+
+
+//Lexer that is handed its input instead of reading it, for input that
+//arrives in pieces (a socket in an event loop). Feed takes bytes in chunks of
+//any size and Next gives each token once it is complete; a token cut by the
+//end of a chunk keeps its lexer state and bytes until the next Feed finishes
+//it. Finish marks the end of input and queues the last tokens and DONE.
+//Tokens own their lexemes and carry their offset in the whole input; they
+//and their lines are what getNextToken gives on all of it at once.
+class PushLexer {
+	string	buf;	// input not yet made into tokens
+	size_t	tokStart;	// first byte of the token in progress
+	size_t	pos;	// where lexing resumes
+	size_t	dropped;	// bytes of input erased from the front of buf
+	unsigned	state;	// lexer state inside the token in progress
+	int	linenum;
+	bool	finished;
+	bool	done;
+	deque<LexItem>	ready;
+
+	void	Pump();
+
+public:
+	explicit PushLexer(int line = 1);
+
+	void	Feed(const char* data, size_t len);
+	void	Finish();
+	//Next complete token; false until more input or Finish completes one
+	bool	Next(LexItem& tok);
+	int	Line() const { return linenum; }
+	bool	Done() const { return done && ready.empty(); }
+};
+
+
+//Keywords, matched case-insensitively by length and then in place
+inline constexpr char LowerAscii(char c)
+{
+	return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+inline constexpr bool SameNoCase(string_view lexeme, const char* kw)
+{
+	for( size_t i = 0; i < lexeme.size(); i++ )
+	{
+		if( LowerAscii(lexeme[i]) != kw[i] )
+			return false;
+	}
+	return true;
+}
+
+inline constexpr Token KeywordToken(string_view lexeme)
+{
+	switch( lexeme.size() )
+	{
+	case 2:
+		if( SameNoCase(lexeme, "if") ) return IF;
+		break;
+	case 4:
+		if( SameNoCase(lexeme, "else") ) return ELSE;
+		break;
+	case 7:
+		if( SameNoCase(lexeme, "println") ) return PRINTLN;
+		break;
+	}
+	return IDENT;
+}
+
+
+
+extern ostream& operator<<(ostream& out, const LexItem& tok);
+extern LexItem id_or_kw(const string& lexeme, int linenum);
+extern LexItem getNextToken(istream& in, int& linenum);
+//Table-driven (lexdfa.cpp); getNextTokenLegacy runs the hand-written state
+//machine on the same input and must return the same tokens, and counts the
+//lines the table gives them
+extern TokenView getNextToken(SourceCursor& src);
+extern TokenView getNextTokenLegacy(SourceCursor& src, int& linenum);
+extern LexItem getNextToken(BlockReader& src, int& linenum);
+
+
+#endif /* LEX_H_ */
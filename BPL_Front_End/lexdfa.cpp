@@ -0,0 +1,418 @@
+/*
+ * lexdfa.cpp
+ *
+ * CS280 - Fall 2025
+ * Table-driven lexer for the Basic Perl-Like (BPL) Language
+ */
+
+#include <array>
+#include <cstdint>
+
+using namespace std;
+
+#include "lex.h"
+#include "scan.h"
+
+//The tokens are described by the Rules below, one line per transition, and
+//turned into a state x character-class table at compile time. Lexing a token
+//is then a loop of table lookups that stops at the first move that is not a
+//plain add or skip. The moves reproduce the hand-written lexer exactly,
+//including its lookahead: a token cut off by end of input is lost (DONE), and
+//the newline that ends a bad string or follows '@' does not count as a line.
+
+namespace {
+
+enum Class : uint8_t {
+	C_ALPHA, C_E, C_X, C_Q, C_G, C_T, C_L,	// letters the rules single out
+	C_DOLLAR, C_UNDER, C_DIGIT,
+	C_NL, C_SPACE, C_SQ, C_DQ, C_HASH, C_AT,
+	C_PLUS, C_MINUS, C_STAR, C_SLASH, C_PCT, C_EQ,
+	C_LP, C_RP, C_LB, C_RB, C_SEMI, C_COMMA,
+	C_GT, C_LT, C_BANG, C_AMP, C_BAR, C_DOT,
+	C_OTHER, C_EOF,
+	NCLASSES
+};
+
+enum State : uint8_t {
+	S_START, S_ID, S_INT, S_IDOT, S_FRAC, S_FEXP, S_FDOT,
+	S_SQ, S_DQ, S_COMMENT,
+	S_AT, S_ATE, S_ATG, S_ATL,
+	S_PLUS, S_MINUS, S_STAR, S_EQ, S_GT, S_AMP, S_BAR, S_DOT, S_DOTX,
+	NSTATES
+};
+
+enum Act : uint8_t {
+	ADD,		// consume, part of the lexeme
+	SKIP,		// consume, lexeme starts after it; a newline counts a line
+	EMIT,		// token is the lexeme; leave this char
+	ADD_EMIT,	// consume this char, then emit
+	DROP_EMIT,	// consume this char but leave it out of the lexeme
+	BACK_EMIT,	// give back the last char added, then emit
+	TRIM_EMIT,	// emit without the last char added; leave this char
+	QUOTE_EMIT,	// consume the closing quote; emit what is between the quotes
+	END,		// DONE
+};
+
+//Bulk run taken right after a move, through the scan.h kernels
+enum Run : uint8_t { R_NONE, R_SPACE, R_COMMENT, R_IDENT, R_DIGITS, R_SQ, R_DQ };
+
+typedef uint64_t ClassSet;
+
+constexpr ClassSet Of(Class c) { return ClassSet(1) << c; }
+constexpr ClassSet ANY = (ClassSet(1) << NCLASSES) - 1;
+constexpr ClassSet LETTERS = Of(C_ALPHA) | Of(C_E) | Of(C_X) | Of(C_Q) | Of(C_G) | Of(C_T) | Of(C_L);
+constexpr ClassSet IDCHARS = LETTERS | Of(C_DOLLAR) | Of(C_UNDER) | Of(C_DIGIT);
+
+struct Rule {
+	State from;
+	ClassSet on;
+	Act act;
+	State to;
+	Token tok;
+	Run run;
+};
+
+//Later rules for a state override earlier ones, so each state lists its
+//default first
+constexpr Rule Rules[] = {
+	{ S_START, ANY, ADD_EMIT, S_START, ERR, R_NONE },
+	{ S_START, Of(C_EOF), END, S_START, DONE, R_NONE },
+	{ S_START, Of(C_NL) | Of(C_SPACE), SKIP, S_START, ERR, R_SPACE },
+	{ S_START, Of(C_HASH), SKIP, S_COMMENT, ERR, R_COMMENT },
+	{ S_START, LETTERS | Of(C_DOLLAR), ADD, S_ID, ERR, R_IDENT },
+	{ S_START, Of(C_DIGIT), ADD, S_INT, ERR, R_DIGITS },
+	{ S_START, Of(C_SQ), ADD, S_SQ, ERR, R_SQ },
+	{ S_START, Of(C_DQ), ADD, S_DQ, ERR, R_DQ },
+	{ S_START, Of(C_AT), ADD, S_AT, ERR, R_NONE },
+	{ S_START, Of(C_PLUS), ADD, S_PLUS, ERR, R_NONE },
+	{ S_START, Of(C_MINUS), ADD, S_MINUS, ERR, R_NONE },
+	{ S_START, Of(C_STAR), ADD, S_STAR, ERR, R_NONE },
+	{ S_START, Of(C_EQ), ADD, S_EQ, ERR, R_NONE },
+	{ S_START, Of(C_GT), ADD, S_GT, ERR, R_NONE },
+	{ S_START, Of(C_AMP), ADD, S_AMP, ERR, R_NONE },
+	{ S_START, Of(C_BAR), ADD, S_BAR, ERR, R_NONE },
+	{ S_START, Of(C_DOT), ADD, S_DOT, ERR, R_NONE },
+	{ S_START, Of(C_SLASH), ADD_EMIT, S_START, DIV, R_NONE },
+	{ S_START, Of(C_PCT), ADD_EMIT, S_START, REM, R_NONE },
+	{ S_START, Of(C_LP), ADD_EMIT, S_START, LPAREN, R_NONE },
+	{ S_START, Of(C_RP), ADD_EMIT, S_START, RPAREN, R_NONE },
+	{ S_START, Of(C_LB), ADD_EMIT, S_START, LBRACES, R_NONE },
+	{ S_START, Of(C_RB), ADD_EMIT, S_START, RBRACES, R_NONE },
+	{ S_START, Of(C_SEMI), ADD_EMIT, S_START, SEMICOL, R_NONE },
+	{ S_START, Of(C_COMMA), ADD_EMIT, S_START, COMMA, R_NONE },
+	{ S_START, Of(C_LT), ADD_EMIT, S_START, NLT, R_NONE },
+	{ S_START, Of(C_BANG), ADD_EMIT, S_START, NOT, R_NONE },
+
+	{ S_COMMENT, ANY, SKIP, S_COMMENT, ERR, R_COMMENT },
+	{ S_COMMENT, Of(C_NL), SKIP, S_START, ERR, R_SPACE },
+	{ S_COMMENT, Of(C_EOF), END, S_START, DONE, R_NONE },
+
+	{ S_ID, ANY, EMIT, S_START, IDENT, R_NONE },
+	{ S_ID, IDCHARS, ADD, S_ID, ERR, R_IDENT },
+	{ S_ID, Of(C_EOF), END, S_START, DONE, R_NONE },
+
+	//integer, then "d.d" fraction with any number of "e[+-]d" exponents
+	{ S_INT, ANY, EMIT, S_START, ICONST, R_NONE },
+	{ S_INT, Of(C_DIGIT), ADD, S_INT, ERR, R_DIGITS },
+	{ S_INT, Of(C_DOT), ADD, S_IDOT, ERR, R_NONE },
+	{ S_INT, Of(C_EOF), END, S_START, DONE, R_NONE },
+	{ S_IDOT, ANY, BACK_EMIT, S_START, FCONST, R_NONE },
+	{ S_IDOT, Of(C_DIGIT), ADD, S_FRAC, ERR, R_DIGITS },
+	{ S_FRAC, ANY, EMIT, S_START, FCONST, R_NONE },
+	{ S_FRAC, Of(C_DIGIT), ADD, S_FRAC, ERR, R_DIGITS },
+	{ S_FRAC, Of(C_E), ADD, S_FEXP, ERR, R_NONE },
+	{ S_FRAC, Of(C_DOT), ADD, S_FDOT, ERR, R_NONE },
+	{ S_FRAC, Of(C_EOF), END, S_START, DONE, R_NONE },
+	{ S_FEXP, ANY, BACK_EMIT, S_START, FCONST, R_NONE },
+	{ S_FEXP, Of(C_PLUS) | Of(C_MINUS) | Of(C_DIGIT), ADD, S_FRAC, ERR, R_DIGITS },
+	{ S_FDOT, ANY, BACK_EMIT, S_START, FCONST, R_NONE },
+	{ S_FDOT, Of(C_DIGIT), EMIT, S_START, ERR, R_NONE },
+
+	{ S_SQ, ANY, ADD, S_SQ, ERR, R_SQ },
+	{ S_SQ, Of(C_SQ), QUOTE_EMIT, S_START, SCONST, R_NONE },
+	{ S_SQ, Of(C_NL), DROP_EMIT, S_START, ERR, R_NONE },
+	{ S_SQ, Of(C_EOF), END, S_START, DONE, R_NONE },
+	{ S_DQ, ANY, ADD, S_DQ, ERR, R_DQ },
+	{ S_DQ, Of(C_DQ), QUOTE_EMIT, S_START, SCONST, R_NONE },
+	{ S_DQ, Of(C_NL), DROP_EMIT, S_START, ERR, R_NONE },
+	{ S_DQ, Of(C_EOF), END, S_START, DONE, R_NONE },
+
+	//@eq, @gt, @le in any case; otherwise "@" is an error and eats one char
+	{ S_AT, ANY, DROP_EMIT, S_START, ERR, R_NONE },
+	{ S_AT, Of(C_E), ADD, S_ATE, ERR, R_NONE },
+	{ S_AT, Of(C_G), ADD, S_ATG, ERR, R_NONE },
+	{ S_AT, Of(C_L), ADD, S_ATL, ERR, R_NONE },
+	{ S_AT, Of(C_EOF), END, S_START, DONE, R_NONE },
+	{ S_ATE, ANY, TRIM_EMIT, S_START, ERR, R_NONE },
+	{ S_ATE, Of(C_Q), ADD_EMIT, S_START, SEQ, R_NONE },
+	{ S_ATG, ANY, TRIM_EMIT, S_START, ERR, R_NONE },
+	{ S_ATG, Of(C_T), ADD_EMIT, S_START, SGT, R_NONE },
+	{ S_ATL, ANY, TRIM_EMIT, S_START, ERR, R_NONE },
+	{ S_ATL, Of(C_E), ADD_EMIT, S_START, SLTE, R_NONE },
+
+	{ S_PLUS, ANY, EMIT, S_START, PLUS, R_NONE },
+	{ S_PLUS, Of(C_EQ), ADD_EMIT, S_START, CADDA, R_NONE },
+	{ S_MINUS, ANY, EMIT, S_START, MINUS, R_NONE },
+	{ S_MINUS, Of(C_EQ), ADD_EMIT, S_START, CSUBA, R_NONE },
+	{ S_STAR, ANY, EMIT, S_START, MULT, R_NONE },
+	{ S_STAR, Of(C_STAR), ADD_EMIT, S_START, EXPONENT, R_NONE },
+	{ S_EQ, ANY, EMIT, S_START, ASSOP, R_NONE },
+	{ S_EQ, Of(C_EQ), ADD_EMIT, S_START, NEQ, R_NONE },
+	{ S_GT, ANY, EMIT, S_START, ERR, R_NONE },
+	{ S_GT, Of(C_EQ), ADD_EMIT, S_START, NGTE, R_NONE },
+	{ S_AMP, ANY, EMIT, S_START, ERR, R_NONE },
+	{ S_AMP, Of(C_AMP), ADD_EMIT, S_START, AND, R_NONE },
+	{ S_BAR, ANY, EMIT, S_START, ERR, R_NONE },
+	{ S_BAR, Of(C_BAR), ADD_EMIT, S_START, OR, R_NONE },
+	{ S_DOT, ANY, EMIT, S_START, CAT, R_NONE },
+	{ S_DOT, Of(C_EQ), ADD_EMIT, S_START, CCATA, R_NONE },
+	{ S_DOT, Of(C_X), ADD, S_DOTX, ERR, R_NONE },
+	{ S_DOTX, ANY, EMIT, S_START, ERR, R_NONE },
+	{ S_DOTX, Of(C_DOT), ADD_EMIT, S_START, SREPEAT, R_NONE },
+};
+
+constexpr Class ClassOf(int ch)
+{
+	if( ch >= 'A' && ch <= 'Z' ) ch += 'a' - 'A';
+	switch( ch ) {
+	case 'e': return C_E;
+	case 'x': return C_X;	// only a lowercase x makes ".x."; fixed below
+	case 'q': return C_Q;
+	case 'g': return C_G;
+	case 't': return C_T;
+	case 'l': return C_L;
+	case '$': return C_DOLLAR;
+	case '_': return C_UNDER;
+	case '\n': return C_NL;
+	case ' ': case '\t': case '\v': case '\f': case '\r': return C_SPACE;
+	case '\'': return C_SQ;
+	case '"': return C_DQ;
+	case '#': return C_HASH;
+	case '@': return C_AT;
+	case '+': return C_PLUS;
+	case '-': return C_MINUS;
+	case '*': return C_STAR;
+	case '/': return C_SLASH;
+	case '%': return C_PCT;
+	case '=': return C_EQ;
+	case '(': return C_LP;
+	case ')': return C_RP;
+	case '{': return C_LB;
+	case '}': return C_RB;
+	case ';': return C_SEMI;
+	case ',': return C_COMMA;
+	case '>': return C_GT;
+	case '<': return C_LT;
+	case '!': return C_BANG;
+	case '&': return C_AMP;
+	case '|': return C_BAR;
+	case '.': return C_DOT;
+	}
+	if( ch >= 'a' && ch <= 'z' ) return C_ALPHA;
+	if( ch >= '0' && ch <= '9' ) return C_DIGIT;
+	return C_OTHER;
+}
+
+//indexed by byte; 256 is end of input
+constexpr array<uint8_t, 257> MakeClasses()
+{
+	array<uint8_t, 257> cls{};
+	for( int ch = 0; ch < 256; ch++ )
+		cls[ch] = ClassOf(ch);
+	cls['X'] = C_ALPHA;
+	cls[256] = C_EOF;
+	return cls;
+}
+
+struct Move {
+	uint8_t next;
+	uint8_t act;
+	uint8_t tok;
+	uint8_t run;
+};
+
+typedef array<array<Move, NCLASSES>, NSTATES> MoveTable;
+
+constexpr MoveTable MakeMoves()
+{
+	MoveTable moves{};
+	for( const Rule& r : Rules )
+		for( int c = 0; c < NCLASSES; c++ )
+			if( r.on & Of(Class(c)) )
+				moves[r.from][c] = Move{ r.to, r.act, uint8_t(r.tok), r.run };
+	return moves;
+}
+
+constexpr array<uint8_t, 257> Classes = MakeClasses();
+constexpr MoveTable Moves = MakeMoves();
+
+//every state must say what happens at end of input
+constexpr bool EveryStateEnds()
+{
+	for( int s = 0; s < NSTATES; s++ )
+		if( Moves[s][C_EOF].act == ADD || Moves[s][C_EOF].act == SKIP )
+			return false;
+	return true;
+}
+
+static_assert(Classes['x'] == C_X && Classes['X'] == C_ALPHA && Classes['E'] == C_E, "letter classes");
+static_assert(Moves[S_DOTX][C_DOT].tok == SREPEAT && Moves[S_ATL][C_E].tok == SLTE, "rule table");
+static_assert(EveryStateEnds(), "a state has no move for end of input");
+
+//Takes moves from state over [p, end) until one ends the token, which is
+//left in m; p is then at the char it was taken on and start at the lexeme.
+//Counting adds each newline skipped to lines as it passes. A Partial run
+//stops at end instead of treating it as end of input, and returns false.
+template<bool Counting, bool Partial>
+inline bool Advance(unsigned& state, const char*& p, const char* end, const char*& start, int& lines, Move& m)
+{
+	while( true ) {
+		if( Partial && p == end )
+			return false;
+		unsigned cls = p < end ? Classes[(unsigned char)*p] : unsigned(C_EOF);
+		m = Moves[state][cls];
+		if( m.act > SKIP )
+			return true;
+
+		if( Counting )
+			lines += (m.act == SKIP) & (*p == '\n');
+		p++;
+		switch( m.run ) {
+		case R_NONE: break;
+		case R_SPACE: p = Counting ? scan::SkipSpace(p, end, lines) : scan::SkipSpace(p, end); break;
+		case R_COMMENT: p = scan::FindByte(p, end, '\n', '\n', '\n'); break;
+		case R_IDENT: p = scan::SkipIdent(p, end); break;
+		case R_DIGITS: p = scan::SkipDigits(p, end); break;
+		case R_SQ: p = scan::FindByte(p, end, '\'', '\n', '\''); break;
+		case R_DQ: p = scan::FindByte(p, end, '"', '\n', '"'); break;
+		}
+		if( m.act == SKIP )
+			start = p;
+		state = m.next;
+	}
+}
+
+//What the move m, taken at p, makes of the lexeme begun at start
+struct Ending {
+	Token	tok;
+	const char*	lex;
+	size_t	len;
+	const char*	next;	// where the following token is looked for
+};
+
+inline Ending EndToken(const Move& m, const char* start, const char* p)
+{
+	Ending e = { Token(m.tok), start, size_t(p - start), p };
+	switch( m.act ) {
+	case ADD_EMIT:
+		e.len++;
+		e.next++;
+		break;
+	case DROP_EMIT:
+		e.next++;
+		break;
+	case BACK_EMIT:
+		e.len--;
+		e.next--;
+		break;
+	case TRIM_EMIT:
+		e.len--;
+		break;
+	case QUOTE_EMIT:
+		e.lex++;
+		e.len--;
+		e.next++;
+		break;
+	case END:
+		e.tok = DONE;
+		e.lex = p;
+		e.len = 0;
+		break;
+	}
+	if( e.tok == IDENT )
+		e.tok = KeywordToken(string_view(e.lex, e.len));
+	return e;
+}
+
+} // namespace
+
+TokenView getNextToken(SourceCursor& src)
+{
+	const char* p = src.cur;
+	const char* start = p;
+	unsigned state = S_START;
+	int uncounted = 0;
+	Move m;
+
+	Advance<false, false>(state, p, src.end, start, uncounted, m);
+	Ending e = EndToken(m, start, p);
+	src.cur = e.next;
+	if( m.act == END )
+		return TokenView(DONE, unsigned(p - src.beg), 0, 0.0);
+	return TokenView(e.tok, unsigned(start - src.beg), e.lex, e.len);
+}
+
+PushLexer::PushLexer(int line)
+	: tokStart(0), pos(0), dropped(0), state(S_START), linenum(line), finished(false), done(false)
+{
+}
+
+void PushLexer::Feed(const char* data, size_t len)
+{
+	if( finished )
+		return;
+	buf.append(data, len);
+	Pump();
+}
+
+void PushLexer::Finish()
+{
+	finished = true;
+	Pump();
+}
+
+bool PushLexer::Next(LexItem& tok)
+{
+	if( ready.empty() )
+		return false;
+	tok = ready.front();
+	ready.pop_front();
+	return true;
+}
+
+void PushLexer::Pump()
+{
+	while( !done ) {
+		const char* b = buf.data();
+		const char* p = b + pos;
+		const char* start = b + tokStart;
+		unsigned st = state;
+		Move m;
+		bool ended = finished
+			? Advance<true, false>(st, p, b + buf.size(), start, linenum, m)
+			: Advance<true, true>(st, p, b + buf.size(), start, linenum, m);
+		pos = p - b;
+		tokStart = start - b;
+		state = st;
+		if( !ended )
+			break;
+
+		Ending e = EndToken(m, start, p);
+		if( m.act == END ) {
+			ready.push_back(LexItem(DONE, string(), linenum, unsigned(dropped + pos)));
+			done = true;
+			break;
+		}
+		ready.push_back(LexItem(e.tok, string(e.lex, e.len), linenum, unsigned(dropped + tokStart)));
+		pos = tokStart = e.next - b;
+		state = S_START;
+	}
+
+	//keep only the token in progress, once that halves the buffer
+	if( tokStart > 0 && tokStart >= buf.size() / 2 ) {
+		buf.erase(0, tokStart);
+		dropped += tokStart;
+		pos -= tokStart;
+		tokStart = 0;
+	}
+}
@@ -0,0 +1,75 @@
+/*
+ * lexpar.cpp
+ * Parallel lexing of large BPL sources in newline-aligned chunks
+ * CS280
+ * Fall 2025
+ */
+
+#include <cstring>
+#include <thread>
+
+#include "lexpar.h"
+#include "workpool.h"
+
+ParallelLexer::ParallelLexer(const LineTable& lines, const char* begin, const char* end, unsigned threads, size_t chunk)
+	: lines(lines), begin(begin), next(begin), end(end), whole(begin, end, &lines),
+	  chunkSize(chunk ? chunk : 1), idx(0)
+{
+	if (threads == 0) threads = thread::hardware_concurrency();
+	window = threads > 1 ? 2 * threads : 0;
+	if (window)
+		WorkPool::Shared().Reserve(threads);
+	while (pending.size() < window && next < end) Launch();
+}
+
+ParallelLexer::Lexed ParallelLexer::LexChunk(const char* b, const char* e)
+{
+	SourceCursor src(b, e);
+	Lexed out;
+	out.base = b;
+	out.toks.reserve((e - b) / 4);
+	while (true) {
+		TokenView t = getNextToken(src);
+		if (t.kind == DONE) break;
+		out.toks.push_back(Tok{ t.kind, t.offset, t.length });
+	}
+	return out;
+}
+
+void ParallelLexer::Launch()
+{
+	const char* b = next;
+	const char* e = end;
+	if ((size_t)(end - b) > chunkSize) {
+		const char* nl = (const char*)memchr(b + chunkSize, '\n', end - b - chunkSize);
+		if (nl) e = nl + 1;
+	}
+	next = e;
+	pending.push_back(WorkPool::Shared().Submit([b, e] { return LexChunk(b, e); }));
+}
+
+ParallelLexer::~ParallelLexer()
+{
+	//chunks still being lexed point into the source
+	for (future<Lexed>& f : pending)
+		f.wait();
+}
+
+TokenView ParallelLexer::Next()
+{
+	if (window == 0)
+		return getNextToken(whole);
+
+	while (idx == cur.toks.size()) {
+		if (pending.empty())
+			return TokenView(DONE, unsigned(end - begin), 0, 0.0);
+		cur = pending.front().get();
+		pending.pop_front();
+		idx = 0;
+		if (next < end) Launch();
+	}
+
+	const Tok& t = cur.toks[idx++];
+	const char* at = cur.base + t.at;
+	return TokenView(t.token, unsigned(at - begin), at + (t.token == SCONST), t.length);
+}
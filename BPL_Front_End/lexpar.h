@@ -0,0 +1,67 @@
+/*
+ * lexpar.h
+ * Parallel lexing of large BPL sources in newline-aligned chunks
+ * CS280
+ * Fall 2025
+*/
+
+#ifndef LEXPAR_H_
+#define LEXPAR_H_
+
+#include <vector>
+#include <deque>
+#include <future>
+
+using namespace std;
+
+#include "lex.h"
+
+//Cuts the source into chunks that start right after a newline and lexes up
+//to a window of them ahead on worker threads. No BPL token, string or comment
+//continues past a newline, so every chunk starts in the lexer's start state,
+//needs nothing from the ones before it, and the tokens are exactly what
+//getNextToken gives on the whole source.
+class ParallelLexer {
+	//every token from a cursor is a view into the source, so a chunk only
+	//needs to keep where each one is
+	struct Tok {
+		Token	token;
+		unsigned	at;	// first byte, from the chunk start
+		unsigned	length;	// of the lexeme, which skips an SCONST's quote
+	};
+	struct Lexed {
+		const char* base = nullptr;
+		vector<Tok> toks;
+	};
+
+	const LineTable& lines;
+	const char* begin;
+	const char* next;	// start of the next chunk to launch
+	const char* end;
+	SourceCursor whole;	// used instead when there is one thread
+	size_t chunkSize;
+	size_t window;	// 0 when lexing on the caller's thread
+	deque<future<Lexed>> pending;
+	Lexed cur;
+	size_t idx;
+
+	static Lexed LexChunk(const char* b, const char* e);
+	void Launch();
+
+public:
+	//[begin, end) lies in the source lines was built from; threads = 0 uses
+	//every hardware thread
+	ParallelLexer(const LineTable& lines, const char* begin, const char* end, unsigned threads = 0, size_t chunk = 256 * 1024);
+
+	~ParallelLexer();
+	ParallelLexer(const ParallelLexer&) = delete;
+	ParallelLexer& operator=(const ParallelLexer&) = delete;
+
+	TokenView Next();
+	//The text the tokens are views of, with offsets from begin, and the
+	//line table of the source it lies in
+	const char* Begin() const { return begin; }
+	const LineTable* Lines() const { return &lines; }
+};
+
+#endif /* LEXPAR_H_ */
@@ -0,0 +1,250 @@
+/*
+ * lltable.h
+ * The BPL grammar and its LL(1) parse table, worked out by the compiler
+ * CS280
+ * Fall 2025
+*/
+
+#ifndef LLTABLE_H_
+#define LLTABLE_H_
+
+#include <cstdint>
+#include <initializer_list>
+
+using namespace std;
+
+#include "lex.h"
+
+//The grammar is the one the recursive-descent rules in parser.cpp follow,
+//with the repetitions written as right-recursive tails. Actions in the
+//productions build the tree: the table engine runs one when it pops it,
+//at the point where the matching rule calls Leaf or Join. Error actions
+//word a syntax error: one follows the symbol whose failure the rule that
+//holds it reports, and runs only when that symbol fails.
+namespace ll1 {
+
+//Symbols: every Token, RELLEX, then the nonterminals, then the actions
+const uint8_t RELLEX = DONE + 1;	// any token spelled as a numeric relation
+const int TermCount = RELLEX + 1;
+
+enum Symbol : uint8_t {
+	NT_PROG = TermCount, NT_BLOCK, NT_TAILTOP, NT_TAIL, NT_STMT,
+	NT_PRINTLN, NT_IF, NT_ELSE, NT_ASSIGN, NT_VAR, NT_ASSIGOP,
+	NT_EXPRLIST, NT_EXPRTAIL, NT_EXPR, NT_OR, NT_ORTAIL, NT_AND, NT_ANDTAIL,
+	NT_REL, NT_RELTAIL, NT_ADD, NT_ADDTAIL, NT_MULT, NT_MULTTAIL,
+	NT_UNARY, NT_SIGNED, NT_EXPON, NT_EXPONTAIL, NT_PRIMARY,
+	NT_BLOCK3, NT_SEMI3, NT_TAIL3,	// prog3's statement lists
+
+	A_OP,		// keep the token just matched for a node made later
+	A_VAR,		// the variable assigned to
+	A_IDENT,	// a variable read, which prog2 wants assigned before
+	A_LEAF,		// a constant
+	A_PAREN,	// one more pair of parentheses around the last node; drops the kept '('
+	A_UNARY,	// the last node, under the kept token
+	A_BINARY,	// the last two nodes, under the kept token
+	A_BLOCK,	// the nodes since the production began, as a block
+	A_PRINTLN, A_IF, A_ASSIGN,	// the same, under the kept keyword or operator
+	A_FAIL,		// where the rules find an error, worded by its error action
+	A_DROP,		// forget the token kept last
+	A_CATCH,	// the engine's: where a rule ends that has an error action
+
+	//Error actions, each for the failure of the symbol before it
+	G_PRINTLN_LP, G_PRINTLN_LIST, G_PRINTLN_RP,
+	G_IF_LP, G_IF_COND, G_IF_RP, G_IF_LBRACE, G_IF_BLOCK, G_IF_RBRACE,
+	G_ELSE_LBRACE, G_ELSE_BLOCK, G_ELSE_RBRACE,
+	G_ASSIGN_OP, G_ASSIGN_EXPR, G_SEMI, G_ILLEGAL_ELSE,
+	G_OR_OPERAND, G_AND_OPERAND, G_REL_OPERAND, G_ADD_OPERAND, G_MULT_OPERAND,
+	G_SIGNED,	// the operand of a sign or '!'
+	G_EXPONENT,	// a power's exponent
+	G_POWER,	// every power it is the exponent of, in prog3
+	G_PAREN_EXPR, G_PAREN_CLOSE,
+	SymbolEnd
+};
+
+const int NontermCount = A_OP - NT_PROG;
+const uint8_t None = 0xFF;
+
+constexpr bool IsTerm(int s) { return s < TermCount; }
+constexpr bool IsNonterm(int s) { return s >= NT_PROG && s < A_OP; }
+constexpr bool IsErrorAction(int s) { return s >= G_PRINTLN_LP && s < SymbolEnd; }
+
+//prog2 looks at the next token before it parses these, and reports its
+//error without the ones the rule would have found
+constexpr bool IsPrechecked(int g) {
+	return g == G_ADD_OPERAND || g == G_MULT_OPERAND || g == G_EXPONENT || g == G_PAREN_EXPR;
+}
+
+struct Production {
+	uint8_t	lhs;
+	uint8_t	len;
+	uint8_t	rhs[10];
+	uint8_t	onError[10];	// error action for each symbol, or 0
+};
+
+//An error action is not a symbol of its own: it goes with the one before it
+constexpr Production P(uint8_t lhs, initializer_list<uint8_t> rhs) {
+	Production p{lhs, 0, {}, {}};
+	for( uint8_t s : rhs ) {
+		if( IsErrorAction(s) )
+			p.onError[p.len - 1] = s;
+		else
+			p.rhs[p.len++] = s;
+	}
+	return p;
+}
+
+//A nonterminal's empty production is taken on any token none of its others
+//starts with, the way each rule's loop stops at a token it does not want
+constexpr Production Grammar[] = {
+	P(NT_PROG,		{ NT_STMT, SEMICOL, G_SEMI, NT_TAILTOP, A_BLOCK }),
+	P(NT_TAILTOP,	{ NT_STMT, SEMICOL, G_SEMI, NT_TAILTOP }),
+	P(NT_TAILTOP,	{ ELSE, A_OP, A_FAIL, G_ILLEGAL_ELSE }),
+	P(NT_TAILTOP,	{}),
+	P(NT_BLOCK,		{ NT_STMT, SEMICOL, G_SEMI, NT_TAIL, A_BLOCK }),
+	P(NT_TAIL,		{ NT_STMT, SEMICOL, G_SEMI, NT_TAIL }),
+	P(NT_TAIL,		{}),
+	//prog3 may leave out the last ';' of a list, and has no top-level else
+	P(NT_BLOCK3,	{ NT_STMT, NT_SEMI3, A_BLOCK }),
+	P(NT_SEMI3,		{ SEMICOL, NT_TAIL3 }),
+	P(NT_SEMI3,		{}),
+	P(NT_TAIL3,		{ NT_STMT, NT_SEMI3 }),
+	P(NT_TAIL3,		{}),
+
+	P(NT_STMT,		{ NT_IF }),
+	P(NT_STMT,		{ NT_PRINTLN }),
+	P(NT_STMT,		{ NT_ASSIGN }),
+	P(NT_PRINTLN,	{ PRINTLN, A_OP, LPAREN, G_PRINTLN_LP, NT_EXPRLIST, G_PRINTLN_LIST,
+					  RPAREN, G_PRINTLN_RP, A_PRINTLN }),
+	P(NT_IF,		{ IF, A_OP, LPAREN, G_IF_LP, NT_EXPR, G_IF_COND, RPAREN, G_IF_RP,
+					  LBRACES, G_IF_LBRACE, NT_BLOCK, G_IF_BLOCK, RBRACES, G_IF_RBRACE, NT_ELSE, A_IF }),
+	P(NT_ELSE,		{ ELSE, A_OP, LBRACES, G_ELSE_LBRACE, NT_BLOCK, G_ELSE_BLOCK,
+					  RBRACES, G_ELSE_RBRACE, A_DROP }),
+	P(NT_ELSE,		{}),
+	P(NT_ASSIGN,	{ NT_VAR, NT_ASSIGOP, G_ASSIGN_OP, NT_EXPR, G_ASSIGN_EXPR, A_ASSIGN }),
+	P(NT_VAR,		{ IDENT, A_VAR }),
+	P(NT_ASSIGOP,	{ ASSOP, A_OP }),
+	P(NT_ASSIGOP,	{ CADDA, A_OP }),
+	P(NT_ASSIGOP,	{ CSUBA, A_OP }),
+	P(NT_ASSIGOP,	{ CCATA, A_OP }),
+
+	P(NT_EXPRLIST,	{ NT_EXPR, NT_EXPRTAIL }),
+	P(NT_EXPRTAIL,	{ COMMA, NT_EXPR, NT_EXPRTAIL }),
+	P(NT_EXPRTAIL,	{}),
+	P(NT_EXPR,		{ NT_OR }),
+	P(NT_OR,		{ NT_AND, NT_ORTAIL }),
+	P(NT_ORTAIL,	{ OR, A_OP, NT_AND, G_OR_OPERAND, A_BINARY, NT_ORTAIL }),
+	P(NT_ORTAIL,	{}),
+	P(NT_AND,		{ NT_REL, NT_ANDTAIL }),
+	P(NT_ANDTAIL,	{ AND, A_OP, NT_REL, G_AND_OPERAND, A_BINARY, NT_ANDTAIL }),
+	P(NT_ANDTAIL,	{}),
+	P(NT_REL,		{ NT_ADD, NT_RELTAIL }),
+	P(NT_RELTAIL,	{ SLTE, A_OP, NT_ADD, G_REL_OPERAND, A_BINARY }),
+	P(NT_RELTAIL,	{ SGT, A_OP, NT_ADD, G_REL_OPERAND, A_BINARY }),
+	P(NT_RELTAIL,	{ SEQ, A_OP, NT_ADD, G_REL_OPERAND, A_BINARY }),
+	P(NT_RELTAIL,	{ RELLEX, A_OP, NT_ADD, G_REL_OPERAND, A_BINARY }),
+	P(NT_RELTAIL,	{}),
+	P(NT_ADD,		{ NT_MULT, NT_ADDTAIL }),
+	P(NT_ADDTAIL,	{ PLUS, A_OP, NT_MULT, G_ADD_OPERAND, A_BINARY, NT_ADDTAIL }),
+	P(NT_ADDTAIL,	{ MINUS, A_OP, NT_MULT, G_ADD_OPERAND, A_BINARY, NT_ADDTAIL }),
+	P(NT_ADDTAIL,	{ CAT, A_OP, NT_MULT, G_ADD_OPERAND, A_BINARY, NT_ADDTAIL }),
+	P(NT_ADDTAIL,	{}),
+	P(NT_MULT,		{ NT_UNARY, NT_MULTTAIL }),
+	P(NT_MULTTAIL,	{ MULT, A_OP, NT_UNARY, G_MULT_OPERAND, A_BINARY, NT_MULTTAIL }),
+	P(NT_MULTTAIL,	{ DIV, A_OP, NT_UNARY, G_MULT_OPERAND, A_BINARY, NT_MULTTAIL }),
+	P(NT_MULTTAIL,	{ REM, A_OP, NT_UNARY, G_MULT_OPERAND, A_BINARY, NT_MULTTAIL }),
+	P(NT_MULTTAIL,	{ SREPEAT, A_OP, NT_UNARY, G_MULT_OPERAND, A_BINARY, NT_MULTTAIL }),
+	P(NT_MULTTAIL,	{}),
+
+	//a sign goes onto the base of a power, '!' onto the whole power, and
+	//a power's operands are folded from the right as the tails unwind
+	P(NT_UNARY,		{ MINUS, A_OP, NT_SIGNED, G_SIGNED }),
+	P(NT_UNARY,		{ PLUS, A_OP, NT_SIGNED, G_SIGNED }),
+	P(NT_UNARY,		{ NOT, A_OP, NT_EXPON, G_SIGNED, A_UNARY }),
+	P(NT_UNARY,		{ NT_EXPON, G_SIGNED }),
+	P(NT_SIGNED,	{ NT_PRIMARY, A_UNARY, NT_EXPONTAIL }),
+	P(NT_EXPON,		{ NT_PRIMARY, NT_EXPONTAIL }),
+	P(NT_EXPONTAIL,	{ EXPONENT, A_OP, NT_PRIMARY, G_EXPONENT, NT_EXPONTAIL, G_POWER, A_BINARY }),
+	P(NT_EXPONTAIL,	{}),
+	P(NT_PRIMARY,	{ IDENT, A_IDENT }),
+	P(NT_PRIMARY,	{ ICONST, A_LEAF }),
+	P(NT_PRIMARY,	{ FCONST, A_LEAF }),
+	P(NT_PRIMARY,	{ SCONST, A_LEAF }),
+	P(NT_PRIMARY,	{ LPAREN, A_OP, NT_EXPR, G_PAREN_EXPR, RPAREN, G_PAREN_CLOSE, A_PAREN }),
+};
+const int ProductionCount = sizeof(Grammar) / sizeof(Grammar[0]);
+
+//Marks the tokens that can start sym. No production starts with a
+//nonterminal that can be empty, so its first symbol is all that counts.
+constexpr void AddFirst(int sym, bool (&first)[TermCount]) {
+	if( IsTerm(sym) ) {
+		first[sym] = true;
+		return;
+	}
+	for( const Production& p : Grammar )
+		if( p.lhs == sym && p.len > 0 )
+			AddFirst(p.rhs[0], first);
+}
+
+struct Table {
+	uint8_t	predict[NontermCount][TermCount];	// production to expand, or None
+	uint8_t	empty[NontermCount];	// the empty production, or None
+	uint8_t	fallInto[NontermCount];	// its only production that starts with a nonterminal, or None
+	bool	wellFormed;	// no two productions start alike, none empty first
+};
+
+constexpr Table MakeTable() {
+	Table t{};
+	t.wellFormed = ProductionCount < None;
+	for( int n = 0; n < NontermCount; n++ ) {
+		t.empty[n] = None;
+		t.fallInto[n] = None;
+		for( int k = 0; k < TermCount; k++ )
+			t.predict[n][k] = None;
+	}
+	uint8_t starts[NontermCount] = {};
+	for( int i = 0; i < ProductionCount; i++ ) {
+		const Production& p = Grammar[i];
+		if( p.len > 0 && IsNonterm(p.rhs[0]) && starts[p.lhs - NT_PROG]++ == 0 )
+			t.fallInto[p.lhs - NT_PROG] = uint8_t(i);
+	}
+	for( int n = 0; n < NontermCount; n++ )
+		if( starts[n] != 1 )
+			t.fallInto[n] = None;
+	for( int i = 0; i < ProductionCount; i++ ) {
+		const Production& p = Grammar[i];
+		uint8_t (&row)[TermCount] = t.predict[p.lhs - NT_PROG];
+		if( p.len == 0 ) {
+			t.wellFormed = t.wellFormed && t.empty[p.lhs - NT_PROG] == None;
+			t.empty[p.lhs - NT_PROG] = uint8_t(i);
+			continue;
+		}
+		bool first[TermCount] = {};
+		AddFirst(p.rhs[0], first);
+		for( int k = 0; k < TermCount; k++ ) {
+			if( !first[k] ) continue;
+			t.wellFormed = t.wellFormed && row[k] == None;
+			row[k] = uint8_t(i);
+		}
+	}
+	for( const Production& p : Grammar )
+		if( p.len > 0 && IsNonterm(p.rhs[0]) )
+			t.wellFormed = t.wellFormed && t.empty[p.rhs[0] - NT_PROG] == None;
+	return t;
+}
+
+constexpr Table ParseTable = MakeTable();
+static_assert(ParseTable.wellFormed, "the BPL grammar must stay LL(1)");
+
+//Production to expand nt by when term is next, or None: a syntax error
+inline uint8_t Predict(uint8_t nt, int term) {
+	uint8_t p = ParseTable.predict[nt - NT_PROG][term];
+	return p != None ? p : ParseTable.empty[nt - NT_PROG];
+}
+
+//Production the rule for nt falls into at a token none of its own start
+//with, or None if the rule reports that token itself
+inline uint8_t FallInto(uint8_t nt) { return ParseTable.fallInto[nt - NT_PROG]; }
+
+} // namespace ll1
+
+#endif /* LLTABLE_H_ */
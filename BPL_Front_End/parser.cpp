@@ -0,0 +1,1453 @@
+/*
+ * parser.cpp
+ * Recursive-descent parser for BPL, with error recovery and syntax tree
+ * CS280
+ * Fall 2025
+*/
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <initializer_list>
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <functional>
+#include <atomic>
+#include "parser.h"
+#include "lex.h"
+#include "tokcache.h"
+#include "lexpar.h"
+#include "ast.h"
+#include "scan.h"
+#include "tokring.h"
+#include "rulestats.h"
+#include "lltable.h"
+#include "workpool.h"
+using namespace std;
+
+namespace bpl {
+
+namespace {
+// The wording of each ErrCode, in the order of the enum
+const char* const ErrText[] = {
+    "Missing semicolon at end of Statement",
+    "Missing operand for an operator",
+    "Missing operand after operator",
+    "Syntactic error in Program Body",
+
+    "Missing Assignment Operator",
+    "Missing Variable in Assignment",
+    "Missing Expression in Assignment Statement",
+    "Incorrect Assignment Statement",
+
+    "Incorrect PrintLn Statement",
+    "Missing Left Parenthesis of PrintLn Statement",
+    "Missing Right Parenthesis of PrintLn Statement",
+
+    "Incorrect If-Statement",
+    "Missing Left Parenthesis of If condition",
+    "Missing Right Parenthesis of If condition",
+    "Missing left brace for If Statement Clause",
+    "Missing right brace for If Statement Clause",
+    "Missing left brace for an Else-Clause",
+    "Missing right brace for an Else-Clause",
+    "Illegal If Statement Else-Clause",
+    "Missing Statement for If Statement Clause",
+    "Missing Statement for Else-Clause",
+
+    "Incorrect Statement",
+    "Missing exponent operand after exponentiation",
+    "Missing expression after Left Parenthesis",
+    "Missing right Parenthesis after expression",
+    "Using Undefined Variable: ",
+
+    "Invalid Statement",
+    "Unexpected token after program end",
+    "Missing '(' in PrintLn",
+    "Invalid expression list in PrintLn",
+    "Missing ')' in PrintLn",
+    "Missing '(' in If condition",
+    "Invalid If condition",
+    "Missing ')' in If condition",
+    "Missing '{' after If condition",
+    "Missing '}' after If block",
+    "Missing '{' in Else clause",
+    "Missing '}' in Else clause",
+    "Missing assignment operator",
+    "Missing Expression in Assignment",
+    "Missing operand for ||",
+    "Missing operand for &&",
+    "Missing relational operand",
+    "Missing operand for + or - or .",
+    "Missing operand for multiplicative operator",
+    "Missing exponent operand",
+    "Missing closing parenthesis",
+    "Invalid Primary Expression",
+};
+static_assert(sizeof(ErrText) / sizeof(ErrText[0]) == E_COUNT, "a message for each ErrCode");
+} // namespace
+
+string FormatError(const Diagnostic& d, const LineTable* lines) {
+    string msg = "Line " + to_string(d.line);
+    if (lines && d.offset != TokenView::NoOffset)
+        msg += ", Column " + to_string(lines->Column(d.offset));
+    msg += ": ";
+    msg += ErrText[d.code];
+    msg += d.name;
+    return msg;
+}
+
+namespace {
+// where tokens come from and what else to do with them: set per thread, so
+// threads checking different programs do not see each other's
+thread_local SourceCursor* gSource = nullptr;
+thread_local BlockReader* gReader = nullptr;
+thread_local TokenCache* gCache = nullptr;
+thread_local ParallelLexer* gChunks = nullptr;
+thread_local const LineTable* gLines = nullptr;
+thread_local Ast* gAst = nullptr;
+thread_local unsigned gParseThreads = 1;
+thread_local ParseEngine gEngine = ENGINE_RD;
+thread_local Dialect gDialect = DIALECT_PROG2;
+
+// An entry of the table engine's stack: a symbol still to match, expand or
+// run, the error action for its failure, how many symbols of its production
+// come after it, and how many nodes were built when that production was
+// expanded; for an A_CATCH, how many tokens were kept instead
+struct Frame {
+    uint8_t sym;
+    uint8_t onError;
+    uint8_t rest;
+    uint32_t from;
+};
+
+// Lexemes of tokens read from a stream, which owns them, copied so that the
+// rules see views of them like of any other token. The rules only read the
+// lexemes of tokens the ring still holds, so older text is let go; where
+// each line's tokens start is kept, to look their lines up like those of a
+// source in memory.
+class StreamText {
+    static const size_t Kept = TokenRing::Size;
+
+    string text;
+    unsigned dropped = 0;  // bytes let go from the front of text
+    unsigned starts[Kept] = {};  // of the last Kept tokens
+    size_t count = 0;
+    int firstLine = 1;
+    vector<unsigned> lineStarts;  // offset of the first token on each line
+
+public:
+    void Clear() {
+        text.clear();
+        dropped = 0;
+        count = 0;
+        lineStarts.clear();
+    }
+    // t as a view of the copy of its lexeme
+    TokenView Add(const LexItem& t) {
+        // t takes the slot of the oldest token in the ring
+        unsigned keep = count + 1 >= Kept ? starts[(count + 1) % Kept] : dropped;
+        if (keep - dropped >= 4096 && keep - dropped >= text.size() / 2) {
+            text.erase(0, keep - dropped);
+            dropped = keep;
+        }
+        unsigned at = dropped + unsigned(text.size());
+        starts[count++ % Kept] = at;
+        if (lineStarts.empty()) firstLine = t.GetLinenum();
+        while (firstLine + int(lineStarts.size()) <= t.GetLinenum()) lineStarts.push_back(at);
+        if (t == SCONST) text += '"';
+        string_view lx = t.GetLexemeView();
+        text.append(lx.data(), lx.size());
+        return TokenView(t.GetToken(), at, lx.size(), t.GetNumber());
+    }
+    string_view Lexeme(const TokenView& t) const {
+        return string_view(text).substr(t.offset - dropped + (t.kind == SCONST), t.length);
+    }
+    // The line the lexer gave the token at offset at
+    int Line(unsigned at) const {
+        return firstLine + int(upper_bound(lineStarts.begin(), lineStarts.end(), at) - lineStarts.begin()) - 1;
+    }
+};
+
+// Everything one parse changes as it goes
+struct ParseState {
+    vector<Diagnostic> errors;
+    vector<size_t> undefined;  // indexes in errors of undefined variables
+    TokenRing ring;
+    StreamText streamed;
+    int streamLine = 1;  // the line the stream lexer is on
+    unsigned lastOffset = TokenView::NoOffset;
+    // where ERR tokens took a newline along; see LineAt
+    vector<unsigned> swallowed;
+
+    // tree under construction: each rule leaves its node on built
+    vector<uint32_t> built;
+    size_t topDone = 0;  // top-level statements built whole
+    TokenView assignOp;
+    TokenView sign;  // a '+' or '-' UnaryExpr leaves for ExponExpr, else ERR
+
+    vector<string> varOrder;
+    set<string, less<>> varSeen;
+    // variables of earlier statements parsed elsewhere, when resuming
+    const function<bool(string_view)>* declaredBefore = nullptr;
+    bool onAssignLHS = false;
+
+    bool printedErrorsThisCall = false;
+
+    int firstLine = 1;  // of a parse that has looked at no token yet
+    unsigned lastTokAt = TokenView::NoOffset;  // the furthest token looked at
+    int lastErrorLine = 1;
+    int lastMissingSemiLine = 0;
+
+    int emitSingleOnce = 0;
+    int emitPairOnce   = 0;
+
+    // the table engine's stack, and the tokens its actions kept
+    vector<Frame> stack;
+    vector<TokenView> ops;
+
+    void Reset(int line) {
+        errors.clear();
+        undefined.clear();
+        varOrder.clear();
+        varSeen.clear();
+        ring.Clear();
+        streamed.Clear();
+        streamLine = line;
+        swallowed.clear();
+        onAssignLHS = false;
+        printedErrorsThisCall = false;
+        firstLine = std::max(1, line);
+        lastTokAt = TokenView::NoOffset;
+        lastErrorLine = firstLine;
+        lastMissingSemiLine = 0;
+        emitSingleOnce = 0;
+        emitPairOnce   = 0;
+        built.clear();
+        topDone = 0;
+        sign = TokenView();
+        declaredBefore = nullptr;
+    }
+};
+
+// the parse in progress on this thread
+thread_local ParseState gState;
+
+inline bool TokIsPrint(const TokenView& t) { return t.kind == PRINTLN; }
+inline bool TokIsIf(const TokenView& t)    { return t.kind == IF; }
+inline bool TokIsElse(const TokenView& t)  { return t.kind == ELSE; }
+
+// The text the tokens are views of, and the table their lines are looked
+// up in; both null when they are read from a stream
+const char* TokenText() {
+    return gCache ? gCache->Begin()
+         : gChunks ? gChunks->Begin()
+         : gSource ? gSource->beg : nullptr;
+}
+const LineTable* TokenLines() {
+    return gCache ? gCache->Lines()
+         : gChunks ? gChunks->Lines()
+         : gSource ? gSource->lines : nullptr;
+}
+string_view Lexeme(const TokenView& t) {
+    const char* text = TokenText();
+    return text ? t.Lexeme(text) : gState.streamed.Lexeme(t);
+}
+
+// What fills the lookahead ring
+struct Lexer {
+    istream& in;
+    TokenView operator()() const {
+        TokenView t = gCache ? gCache->Next()
+             : gChunks ? gChunks->Next()
+             : gSource ? getNextToken(*gSource)
+             : gState.streamed.Add(gReader ? getNextToken(*gReader, gState.streamLine) : getNextToken(in, gState.streamLine));
+        if (t.kind == ERR) {
+            const char* text = TokenText();
+            if (text && t.SwallowsNewline(text)) gState.swallowed.push_back(t.offset);
+        }
+        return t;
+    }
+};
+
+// The line of the token at offset at, as the lexer counts lines: a newline
+// an ERR token took along is none, so the table's line is less one for each
+// such token before at. A stream lexer counted them so itself.
+int LineAt(unsigned at) {
+    if (at == TokenView::NoOffset) return gState.firstLine;
+    const char* text = TokenText();
+    if (!text) return gState.streamed.Line(at);
+    const LineTable* lines = TokenLines();
+    int line = lines ? lines->Line(size_t(text - lines->Begin()) + at) : 1 + int(count(text, text + at, '\n'));
+    const vector<unsigned>& sw = gState.swallowed;
+    return line - int(lower_bound(sw.begin(), sw.end(), at) - sw.begin());
+}
+// The line before the one of the token at at, where a missing ';' or '}'
+// is reported
+int LineBefore(unsigned at) { return max(1, LineAt(at) - 1); }
+// The furthest token looked at, where most errors are placed
+unsigned LastTok() { return gState.lastTokAt; }
+
+// Error messages are placed at the last token looked at, taken or not
+const TokenView& Looked(const TokenView& t, size_t seenBefore) {
+    if (gState.ring.Seen() != seenBefore) gState.lastTokAt = t.offset;
+    gState.lastOffset = t.offset;
+    return t;
+}
+// The returned token stays valid until the next token is read or peeked
+const TokenView& GetTok(istream& in, int&) {
+    RULE_TOKEN();
+    size_t seen = gState.ring.Seen();
+    return Looked(gState.ring.Get(Lexer{in}), seen);
+}
+const TokenView& PeekTok(istream& in, int&) {
+    size_t seen = gState.ring.Seen();
+    return Looked(gState.ring.Peek(1, Lexer{in}), seen);
+}
+void PushBack(const TokenView& t) {
+    RULE_PUSHBACK();
+    gState.ring.PushBack(t);
+}
+bool IsAny(const TokenView& t, initializer_list<Token> ks) {
+    for (auto k: ks) if (t.kind == k) return true;
+    return false;
+}
+// RelExpr takes any token spelled like a numeric relation for one
+bool IsNumericRel(const TokenView& t) {
+    // the lexer only spells them with these
+    if (t.kind != NLT && t.kind != NGTE && t.kind != NEQ && t.kind != ERR) return false;
+    string_view lx = Lexeme(t);
+    if (gDialect == DIALECT_PROG3) return lx == "<" || lx == ">=" || lx == "==";
+    return lx == "<" || lx == "<=" || lx == ">" || lx == ">=" || lx == "==";
+}
+// True if the tokens come straight from gSource, which can be read again
+bool FromSource() {
+    return gSource && !gCache && !gChunks;
+}
+
+// Records an error on line, with its column at the last token read;
+// FormatError words it later. Tokens read from a stream have no place in a
+// source to give a column.
+void ErrorOnLine(int line, ErrCode code, string_view name = {}) {
+    unsigned at = TokenText() ? gState.lastOffset : TokenView::NoOffset;
+    gState.errors.push_back(Diagnostic{code, line, at, string(name)});
+    gState.lastErrorLine = line;
+}
+// The same on the line of the token at offset at
+void ParseError(unsigned at, ErrCode code, string_view name = {}) {
+    ErrorOnLine(LineAt(at), code, name);
+}
+// An error that only one dialect reports where it is found
+void ParseError2(unsigned at, ErrCode code) {
+    if (gDialect == DIALECT_PROG2) ParseError(at, code);
+}
+void ParseError3(unsigned at, ErrCode code) {
+    if (gDialect == DIALECT_PROG3) ParseError(at, code);
+}
+void DefineVarOnce(string_view ident) {
+    if (!gState.varSeen.count(ident)) { gState.varSeen.emplace(ident); gState.varOrder.emplace_back(ident); }
+}
+
+bool Accept(istream& in, int& line, initializer_list<Token> ks, TokenView* out=nullptr) {
+    if (!IsAny(PeekTok(in, line), ks)) return false;
+    const TokenView& t = GetTok(in, line);
+    if (out) *out = t;
+    return true;
+}
+// err is prog2's, at the line of the token found instead; err3 prog3's
+bool Expect(istream& in, int& line, initializer_list<Token> ks, ErrCode err, ErrCode err3) {
+    const TokenView& t = PeekTok(in, line);
+    if (IsAny(t, ks)) { GetTok(in, line); return true; }
+    if (gDialect == DIALECT_PROG3) ParseError(LastTok(), err3);
+    else ParseError(t.offset, err);
+    return false;
+}
+
+bool StartsPrimary(istream& in, int& line) {
+    return IsAny(PeekTok(in, line), {IDENT, ICONST, FCONST, SCONST, LPAREN});
+}
+bool StartsUnary(istream& in, int& line) {
+    return IsAny(PeekTok(in, line), {MINUS, PLUS, NOT, IDENT, ICONST, FCONST, SCONST, LPAREN});
+}
+
+bool MaybeEmitSingle(unsigned at) {
+    if (gState.emitSingleOnce == 1) { ParseError(at, E_MISSING_OPERAND_FOR); gState.emitSingleOnce = 2; return true; }
+    if (gState.emitSingleOnce == 2) return true;
+    return false;
+}
+bool MaybeEmitPair(unsigned at) {
+    if (gState.emitPairOnce == 1) { ParseError(at, E_MISSING_OPERAND_FOR); ParseError(at, E_MISSING_OPERAND_AFTER); gState.emitPairOnce = 2; return true; }
+    if (gState.emitPairOnce == 2) return true;
+    return false;
+}
+
+// ---- AST builders; no-ops unless SetAstOutput was given a tree ----
+void Leaf(NodeKind kind, const TokenView& t) {
+    if (gAst) gState.built.push_back(gAst->Add(kind, t));
+}
+// replaces the nodes built since from with one node that has them as children
+void Join(NodeKind kind, const TokenView& t, size_t from) {
+    if (!gAst) return;
+    uint32_t n = gAst->Add(kind, t);
+    uint32_t* link = &(*gAst)[n].first;
+    for (size_t i = from; i < gState.built.size(); ++i) {
+        *link = gState.built[i];
+        link = &(*gAst)[gState.built[i]].next;
+    }
+    gState.built.resize(from);
+    gState.built.push_back(n);
+    // a nested statement always has its if's condition before it on built
+    if (from == gState.topDone && (kind == N_PRINTLN || kind == N_IF || kind == N_ASSIGN)) gState.topDone++;
+}
+// counts the parentheses around the node built last
+void Parens() {
+    if (gAst) {
+        uint16_t& n = (*gAst)[gState.built.back()].parens;
+        if (n != UINT16_MAX) n++;
+    }
+}
+
+// ---- Panic-mode recovery helper ----
+bool RecoverUntil(istream& in, int& line, initializer_list<Token> sync) {
+    while (true) {
+        RULE_SKIP();
+        Token k = GetTok(in, line).kind;
+        if (k == DONE) return false;
+        for (auto s : sync) if (k == s) return true;
+    }
+}
+} // namespace
+
+int ErrCount() { return (int)gState.errors.size(); }
+void SetTokenSource(SourceCursor* src) { gSource = src; }
+void SetTokenReader(BlockReader* rd) { gReader = rd; }
+void SetTokenCache(TokenCache* cache) { gCache = cache; }
+void SetChunkLexer(ParallelLexer* lexer) { gChunks = lexer; }
+void SetLineTable(const LineTable* lines) { gLines = lines; }
+void SetAstOutput(Ast* ast) { gAst = ast; }
+void SetParseThreads(unsigned threads) { gParseThreads = threads; }
+void SetParseEngine(ParseEngine engine) { gEngine = engine; }
+void SetDialect(Dialect dialect) { gDialect = dialect; }
+
+bool StmtList(istream& in, int& line);
+bool StmtList(istream& in, int& line, bool inIfElseClause);
+bool StmtTail(istream& in, int& line, bool inIfElseClause);
+bool Stmt(istream& in, int& line);
+bool PrintLnStmt(istream& in, int& line);
+bool IfStmt(istream& in, int& line);
+bool AssignStmt(istream& in, int& line);
+bool Var(istream& in, int& line);
+bool ExprList(istream& in, int& line);
+bool AssigOp(istream& in, int& line);
+bool Expr(istream& in, int& line);
+bool OrExpr(istream& in, int& line);
+bool AndExpr(istream& in, int& line);
+bool RelExpr(istream& in, int& line);
+bool AddExpr(istream& in, int& line);
+bool MultExpr(istream& in, int& line);
+bool UnaryExpr(istream& in, int& line);
+bool ExponExpr(istream& in, int& line, int sign);
+bool PrimaryExpr(istream& in, int& line, int sign);
+
+namespace {
+
+// ---- Parallel checking of top-level statements ----
+const size_t ChunkBytes = 128 * 1024;
+
+// The whole source as a cursor over [b, e), so offsets and columns stay
+// those of the source
+SourceCursor CursorAt(const SourceCursor& whole, const char* b, const char* e) {
+    SourceCursor c(b, e, whole.lines);
+    c.beg = whole.beg;
+    return c;
+}
+
+// Stands in for the istream the rules take when tokens come from gSource
+istream& NoStream() {
+    static thread_local istream none(nullptr);
+    return none;
+}
+
+// Moves what a parse found into run
+void TakeRun(StmtRun& run, bool ok) {
+    run.failed = !ok;
+    const TokenView* next = gState.ring.Next();
+    run.reachedEnd = next && next->kind == DONE;
+    run.errors.swap(gState.errors);
+    run.undefined.swap(gState.undefined);
+    run.declared.swap(gState.varOrder);
+    run.lastTokAt = gState.lastTokAt;
+}
+
+StmtRun ParseChunk(const SourceCursor& whole, const char* b, const char* e, bool first,
+                   const atomic<bool>* stop) {
+    StmtRun r;
+    if (stop->load(memory_order_relaxed)) { r.failed = true; return r; }
+    ParseStmtRun(whole, b, e, first, r);
+    return r;
+}
+
+// Parses from b to the end of the source in order, on top of what gState
+// holds of the statements before b
+bool ResumeAt(const SourceCursor& whole, const char* b, bool first, int& line) {
+    SourceCursor* saved = gSource;
+    SourceCursor rest = CursorAt(whole, b, whole.end);
+    gSource = &rest;
+    bool ok = first ? StmtList(NoStream(), line, false) : StmtTail(NoStream(), line, false);
+    line = LineAt(LastTok());
+    gSource = saved;
+    return ok;
+}
+
+// Runs of statements are checked concurrently and merged in source order.
+// The first run with a syntax error is parsed again on this thread, from
+// the merged state, to the end of the source: the parse stops at that
+// error anyway, and its messages then depend only on what came before.
+bool ParseParallel(istream& in, int& line) {
+    SourceCursor* whole = gSource;
+    vector<const char*> cuts = StatementCuts(whole->cur, whole->end, ChunkBytes);
+    if (cuts.size() < 3) return StmtList(in, line, false);
+
+    WorkPool& pool = WorkPool::Shared();
+    pool.Reserve(gParseThreads);
+    atomic<bool> stop(false);
+    deque<future<StmtRun>> pending;
+    size_t next = 0, window = 2 * gParseThreads;
+    auto launch = [&] {
+        const char* b = cuts[next];
+        const char* e = cuts[next + 1];
+        bool first = next == 0;
+        pending.push_back(pool.Submit([whole, b, e, first, &stop] {
+            return ParseChunk(*whole, b, e, first, &stop);
+        }));
+        next++;
+    };
+    // the runs still queued see stop and return at once, but they use the
+    // locals here, so they are waited for
+    auto finish = [&](bool ok) {
+        stop = true;
+        for (future<StmtRun>& f : pending) f.wait();
+        pending.clear();
+        return ok;
+    };
+
+    for (size_t k = 0; k + 1 < cuts.size(); ++k) {
+        while (pending.size() < window && next + 1 < cuts.size()) launch();
+        StmtRun r = pending.front().get();
+        pending.pop_front();
+
+        if (r.failed) {
+            finish(false);
+            return ResumeAt(*whole, cuts[k], k == 0, line);
+        }
+
+        // an undefined use is only an error if no earlier run declared it
+        size_t u = 0;
+        for (size_t i = 0; i < r.errors.size(); ++i) {
+            if (u < r.undefined.size() && r.undefined[u] == i) {
+                u++;
+                if (gState.varSeen.count(r.errors[i].name)) continue;
+            }
+            gState.lastErrorLine = r.errors[i].line;
+            gState.errors.push_back(move(r.errors[i]));
+        }
+        for (string& v : r.declared) DefineVarOnce(v);
+        gState.lastTokAt = r.lastTokAt;
+
+        if (!r.reachedEnd) return finish(true);
+    }
+    return finish(true);
+}
+
+// What prog3 checks once the statements are parsed: that the source ends
+// after them. If they failed, the tree keeps the whole ones before the error.
+bool EndStatements(istream& in, int& line, bool ok) {
+    if (gDialect != DIALECT_PROG3) return ok;
+    if (ok && PeekTok(in, line) != DONE) {
+        ParseError(LastTok(), E_AFTER_END);
+        return false;
+    }
+    if (!ok && gAst) {
+        gState.built.resize(gState.topDone);
+        Join(N_BLOCK, TokenView(), 0);
+    }
+    return ok;
+}
+
+// What Prog adds once the statements are parsed; true if there are no errors
+bool EndProgram(bool ok) {
+    bool addProgBody = !ok && gDialect == DIALECT_PROG2;
+
+    if (!gState.errors.empty()) {
+        if (gState.errors.size() == 1) {
+            ErrCode e = gState.errors.back().code;
+            if (e == E_MISSING_SEMI || e == E_ILLEGAL_ELSE) addProgBody = false;
+        }
+    }
+
+    if (addProgBody) ErrorOnLine(gState.lastErrorLine, E_PROG_BODY);
+
+    if (gAst) {
+        bool keep = gState.errors.empty() || gDialect == DIALECT_PROG3;
+        if (keep && !gState.built.empty()) gAst->SetRoot(gState.built.back());
+        else gAst->Clear();
+    }
+    return gState.errors.empty();
+}
+
+// ---- Table-driven engine ----
+// Runs error action g, reporting what the rule it stands for reports when
+// the symbol before g fails. kept is how many tokens were kept then, the
+// last of them by the rule itself.
+void OnError(istream& in, int& line, uint8_t g, size_t kept) {
+    using namespace ll1;
+    unsigned keptAt = kept ? gState.ops[kept - 1].offset : LastTok();
+    switch (g) {
+    case G_PRINTLN_LP: {
+        const TokenView& t = PeekTok(in, line);
+        if (gDialect == DIALECT_PROG3) ParseError(LastTok(), E_PRINTLN_NO_LP);
+        else ParseError(t.offset, E_PRINTLN_MISSING_LP);
+        ParseError2(keptAt, E_PRINTLN_INCORRECT);
+        break;
+    }
+    case G_PRINTLN_LIST:
+        ParseError2(keptAt, E_MISSING_OPERAND_FOR);
+        ParseError2(keptAt, E_PRINTLN_INCORRECT);
+        ParseError3(LastTok(), E_PRINTLN_BAD_LIST);
+        break;
+    case G_PRINTLN_RP:
+        ParseError2(keptAt, E_PRINTLN_MISSING_RP);
+        ParseError2(keptAt, E_PRINTLN_INCORRECT);
+        ParseError3(LastTok(), E_PRINTLN_NO_RP);
+        break;
+    case G_IF_LP:
+        ParseError2(keptAt, E_IF_MISSING_LP);
+        ParseError2(keptAt, E_IF_INCORRECT);
+        ParseError3(LastTok(), E_IF_NO_LP);
+        break;
+    case G_IF_COND:
+        ParseError2(keptAt, E_MISSING_OPERAND_FOR);
+        ParseError2(keptAt, E_IF_INCORRECT);
+        ParseError3(LastTok(), E_IF_BAD_COND);
+        break;
+    case G_IF_RP:
+        ParseError2(keptAt, E_IF_MISSING_RP);
+        ParseError2(keptAt, E_IF_INCORRECT);
+        ParseError3(LastTok(), E_IF_NO_RP);
+        break;
+    case G_IF_LBRACE: {
+        unsigned anchor = PeekTok(in, line).offset;
+        ParseError2(anchor, E_IF_MISSING_LBRACE);
+        ParseError2(anchor, E_IF_INCORRECT);
+        ParseError3(LastTok(), E_IF_NO_LBRACE);
+        break;
+    }
+    case G_IF_BLOCK:
+        ParseError2(keptAt, E_IF_INCORRECT);
+        break;
+    case G_IF_RBRACE: {
+        const unsigned needIfRBraceAt = LastTok();
+        if (gDialect == DIALECT_PROG3) {
+            ParseError(LastTok(), E_IF_NO_RBRACE);
+            break;
+        }
+        unsigned elseAt = PeekTok(in, line).kind == ELSE ? GetTok(in, line).offset : TokenView::NoOffset;
+        ParseError(needIfRBraceAt, E_IF_MISSING_RBRACE);
+        ParseError(needIfRBraceAt, E_IF_INCORRECT);
+        if (elseAt != TokenView::NoOffset) ParseError(elseAt, E_ILLEGAL_ELSE);
+        break;
+    }
+    case G_ELSE_LBRACE:
+        ParseError2(keptAt, E_ELSE_MISSING_LBRACE);
+        ParseError2(keptAt, E_IF_INCORRECT);
+        ParseError3(LastTok(), E_ELSE_NO_LBRACE);
+        break;
+    case G_ELSE_BLOCK:
+        if (gDialect == DIALECT_PROG2) {
+            int anchor = gState.lastMissingSemiLine ? gState.lastMissingSemiLine : LineBefore(LastTok());
+            ErrorOnLine(anchor, E_MISSING_STMT_ELSE);
+            ErrorOnLine(anchor, E_IF_INCORRECT);
+        }
+        break;
+    case G_ELSE_RBRACE:
+        if (gDialect == DIALECT_PROG2) {
+            int needElseRBraceLine = LineBefore(LastTok());
+            ErrorOnLine(needElseRBraceLine, E_ELSE_MISSING_RBRACE);
+            ErrorOnLine(needElseRBraceLine, E_IF_INCORRECT);
+        }
+        ParseError3(LastTok(), E_ELSE_NO_RBRACE);
+        break;
+    case G_ASSIGN_OP:
+        ParseError2(LastTok(), E_MISSING_ASSIGN_OP);
+        ParseError2(LastTok(), E_INCORRECT_ASSIGN);
+        ParseError3(LastTok(), E_NO_ASSIGN_OP);
+        break;
+    case G_ASSIGN_EXPR:
+        if (gState.emitPairOnce == 0) ParseError2(LastTok(), E_MISSING_EXPR_IN_ASSIGN);
+        ParseError2(LastTok(), E_INCORRECT_ASSIGN);
+        ParseError3(LastTok(), E_NO_ASSIGN_EXPR);
+        break;
+    case G_SEMI: {
+        int reportLine = LineBefore(PeekTok(in, line).offset);
+        gState.lastMissingSemiLine = reportLine;
+        ErrorOnLine(reportLine, E_MISSING_SEMI);
+        RecoverUntil(in, line, {SEMICOL});
+        Accept(in, line, {SEMICOL});
+        break;
+    }
+    case G_ILLEGAL_ELSE:
+        ParseError(keptAt, E_ILLEGAL_ELSE);
+        break;
+    case G_OR_OPERAND:
+    case G_AND_OPERAND:
+    case G_REL_OPERAND:
+    case G_ADD_OPERAND:
+    case G_MULT_OPERAND: {
+        // OrExpr and AndExpr place prog2's pair at the line read last
+        unsigned at = g == G_OR_OPERAND || g == G_AND_OPERAND ? LastTok() : keptAt;
+        if (MaybeEmitSingle(at) || MaybeEmitPair(at)) break;
+        ParseError2(at, E_MISSING_OPERAND_FOR);
+        ParseError2(at, E_MISSING_OPERAND_AFTER);
+        ParseError3(LastTok(), g == G_OR_OPERAND ? E_OR_OPERAND : g == G_AND_OPERAND ? E_AND_OPERAND
+                        : g == G_REL_OPERAND ? E_REL_OPERAND : g == G_ADD_OPERAND ? E_ADD_OPERAND : E_MULT_OPERAND);
+        break;
+    }
+    case G_SIGNED:
+        if (MaybeEmitSingle(LastTok()) || MaybeEmitPair(LastTok())) break;
+        ParseError2(LastTok(), E_MISSING_OPERAND_FOR);
+        ParseError2(LastTok(), E_MISSING_OPERAND_AFTER);
+        break;
+    case G_EXPONENT:
+        if (gDialect == DIALECT_PROG3) {
+            ParseError(LastTok(), E_EXPON_OPERAND);
+            break;
+        }
+        ParseError(LastTok(), E_MISSING_EXPONENT);
+        gState.emitPairOnce = 1;
+        break;
+    case G_POWER:
+        ParseError3(LastTok(), E_EXPON_OPERAND);
+        break;
+    case G_PAREN_EXPR:
+    case G_PAREN_CLOSE:
+        if (gDialect == DIALECT_PROG3) {
+            if (g == G_PAREN_CLOSE) ParseError(LastTok(), E_NO_CLOSE_PAREN);
+            break;
+        }
+        ParseError(keptAt, g == G_PAREN_EXPR ? E_MISSING_EXPR_IN_PARENS : E_MISSING_RPAREN);
+        (g == G_PAREN_EXPR ? gState.emitPairOnce : gState.emitSingleOnce) = 1;
+        RecoverUntil(in, line, {RPAREN, SEMICOL});
+        Accept(in, line, {RPAREN});
+        break;
+    }
+}
+
+// True if error action g reports nothing in the dialect being parsed, so a
+// rule that fails with it needs no A_CATCH frame
+bool Silent(uint8_t g) {
+    using namespace ll1;
+    if (gDialect == DIALECT_PROG2) return g == G_POWER;
+    // prog2's flags that MaybeEmitSingle and MaybeEmitPair test stay clear
+    return g == G_SIGNED || g == G_IF_BLOCK || g == G_ELSE_BLOCK || g == G_PAREN_EXPR;
+}
+
+// What the rules report when nt fails at a token none of its productions
+// start with: the rule goes on into the one it falls into, down to a rule
+// that finds the token wrong itself, and each reports on the way back
+void FallInto(istream& in, int& line, uint8_t nt, size_t kept) {
+    using namespace ll1;
+    uint8_t p = ll1::FallInto(nt);
+    if (p != None) {
+        FallInto(in, line, Grammar[p].rhs[0], kept);
+        OnError(in, line, Grammar[p].onError[0], kept);
+        return;
+    }
+    if (nt == NT_PRIMARY && gDialect == DIALECT_PROG3) {
+        GetTok(in, line);
+        ParseError(LastTok(), E_INVALID_PRIMARY);
+    }
+    else if (nt == NT_STMT) {
+        const TokenView& t = PeekTok(in, line);
+        if (gDialect == DIALECT_PROG3) ParseError(LastTok(), E_INVALID_STMT);
+        else if (TokIsElse(t)) ParseError(t.offset, E_ILLEGAL_ELSE);
+        else ParseError(GetTok(in, line).offset, E_INCORRECT_STMT);
+    }
+}
+
+// Reports the failure of f, just popped, and of every production it ends
+// on the way out: each error action that a failed symbol has on the stack
+// runs, innermost first, as the rules report on their way back
+bool Unwind(istream& in, int& line, const Frame& f, bool unpredicted) {
+    using namespace ll1;
+    vector<Frame>& stack = gState.stack;
+    uint8_t nt = f.sym == NT_BLOCK && gDialect == DIALECT_PROG3 ? uint8_t(NT_BLOCK3) : f.sym;
+    // prog2 looks before it parses some operands, and does not go into them
+    size_t kept = gState.ops.size();
+    if (unpredicted && !(gDialect == DIALECT_PROG2 && IsPrechecked(f.onError))) FallInto(in, line, nt, kept);
+    OnError(in, line, f.onError, kept);
+    stack.resize(stack.size() - f.rest);
+    while (!stack.empty()) {
+        Frame c = stack.back();
+        stack.pop_back();
+        if (c.sym == A_CATCH) OnError(in, line, c.onError, c.from);
+        stack.resize(stack.size() - c.rest);
+    }
+    return false;
+}
+
+// Accepts what the rules accept, and builds the same tree and reports the
+// same errors with the same helpers in the same order, but keeps its place
+// on gState.stack instead of the call stack. A nonterminal whose failure
+// has an error action leaves an A_CATCH frame under its production, which
+// stands for it once it is expanded.
+bool ParseByTable(istream& in, int& line) {
+    using namespace ll1;
+    vector<Frame>& stack = gState.stack;
+    vector<TokenView>& ops = gState.ops;
+    stack.clear();
+    ops.clear();
+    const uint8_t start = gDialect == DIALECT_PROG3 ? NT_BLOCK3 : NT_PROG;
+    stack.push_back({start, 0, 0, uint32_t(gState.built.size())});
+    const TokenView* last = nullptr;  // the token matched last, until the next is read
+
+    while (!stack.empty()) {
+        Frame f = stack.back();
+        stack.pop_back();
+
+        if (IsTerm(f.sym)) {
+            const TokenView& t = PeekTok(in, line);
+            if (f.sym == RELLEX ? !IsNumericRel(t) : t.kind != f.sym) return Unwind(in, line, f, false);
+            last = &GetTok(in, line);
+            continue;
+        }
+        if (IsNonterm(f.sym)) {
+            // prog3's statement lists may leave out the last ';'
+            uint8_t nt = f.sym == NT_BLOCK && gDialect == DIALECT_PROG3 ? uint8_t(NT_BLOCK3) : f.sym;
+            const TokenView& t = PeekTok(in, line);
+            uint8_t p = Predict(nt, nt == NT_RELTAIL && IsNumericRel(t) ? int(RELLEX) : int(t.kind));
+            if (p == None) return Unwind(in, line, f, true);
+            if (f.onError && !Silent(f.onError)) stack.push_back({A_CATCH, f.onError, f.rest, uint32_t(ops.size())});
+            const Production& g = Grammar[p];
+            uint32_t from = uint32_t(gState.built.size());
+            for (int i = g.len; i-- > 0; )
+                stack.push_back({g.rhs[i], g.onError[i], uint8_t(g.len - 1 - i), from});
+            continue;
+        }
+
+        size_t built = gState.built.size();
+        switch (f.sym) {
+        case A_OP:
+            ops.push_back(*last);
+            continue;
+        case A_VAR:
+            DefineVarOnce(Lexeme(*last));
+            Leaf(N_IDENT, *last);
+            continue;
+        case A_IDENT:
+            if (gDialect == DIALECT_PROG2 && !gState.varSeen.count(Lexeme(*last))
+                && !(gState.declaredBefore && (*gState.declaredBefore)(Lexeme(*last)))) {
+                ParseError(last->offset, E_UNDEFINED_VAR, Lexeme(*last));
+                gState.undefined.push_back(gState.errors.size() - 1);
+            }
+            Leaf(N_IDENT, *last);
+            continue;
+        case A_LEAF:
+            Leaf(last->kind == ICONST ? N_ICONST : last->kind == FCONST ? N_FCONST : N_SCONST, *last);
+            continue;
+        case A_BLOCK:
+            Join(N_BLOCK, TokenView(), f.from);
+            continue;
+        case A_CATCH:
+            continue;
+        case A_FAIL:
+            return Unwind(in, line, f, false);
+        case A_PAREN:   Parens(); break;
+        case A_DROP:    break;
+        case A_UNARY:   Join(N_UNARY, ops.back(), built - 1); break;
+        case A_BINARY:  Join(N_BINARY, ops.back(), built - 2); break;
+        case A_PRINTLN: Join(N_PRINTLN, ops.back(), f.from); break;
+        case A_IF:      Join(N_IF, ops.back(), f.from); break;
+        case A_ASSIGN:  Join(N_ASSIGN, ops.back(), f.from); break;
+        }
+        ops.pop_back();
+    }
+    return true;
+}
+
+// Parses a whole program, leaving its errors in gState; true if there are none
+bool ParseProgram(istream& in, int& line) {
+    RULE_SCOPE(R_PROG);
+    gState.Reset(line);
+    if (gAst) gAst->Clear();
+
+    // runs of statements in parallel need the source in memory, with the
+    // line table that gives each run its line numbers
+    bool parallel = gParseThreads > 1 && FromSource() && gSource->lines && !gAst
+                    && gDialect == DIALECT_PROG2 && size_t(gSource->end - gSource->cur) >= 2 * ChunkBytes;
+
+    bool ok = parallel ? ParseParallel(in, line)
+            : gEngine == ENGINE_LL1 ? ParseByTable(in, line)
+            : StmtList(in, line, false);
+    ok = EndProgram(EndStatements(in, line, ok));
+    // where the lexer would have left it
+    line = LineAt(LastTok());
+    return ok;
+}
+} // namespace
+
+vector<const char*> StatementCuts(const char* p, const char* end, size_t step) {
+    vector<const char*> cuts{p};
+    const char* next = p + step;
+    int depth = 0;
+    while ((p = scan::FindByte(p, end, ';', '{', '}', '#', '\'', '"', '@')) < end) {
+        char c = *p++;
+        switch (c) {
+        case '@': if (p < end) p++; break;  // the lexer takes the next byte with it
+        case '{': depth++; break;
+        case '}': depth--; break;
+        case '#': p = scan::FindByte(p, end, '\n', '\n', '\n'); break;
+        case '\'': case '"':
+            p = scan::FindByte(p, end, c, '\n', c);
+            if (p < end && *p == c) p++;
+            break;
+        default:
+            if (depth <= 0 && p >= next && p < end) { cuts.push_back(p); next = p + step; }
+        }
+    }
+    cuts.push_back(end);
+    return cuts;
+}
+
+void ParseStmtRun(const SourceCursor& whole, const char* b, const char* e, bool first, StmtRun& run) {
+    SourceCursor* saved = gSource;
+    SourceCursor cur = CursorAt(whole, b, e);
+    gSource = &cur;
+    int line = whole.lines->Line(b - whole.lines->Begin());
+    gState.Reset(line);
+    TakeRun(run, first ? StmtList(NoStream(), line, false) : StmtTail(NoStream(), line, false));
+    gSource = saved;
+}
+
+bool ResumeProg(const SourceCursor& whole, const char* b, bool first, const StmtRun& prior,
+                const function<bool(string_view)>& declaredBefore, vector<Diagnostic>& errors) {
+    RULE_SCOPE(R_PROG);
+    gState.Reset(1);
+    gState.errors = prior.errors;
+    if (!prior.errors.empty()) gState.lastErrorLine = prior.errors.back().line;
+    gState.lastTokAt = prior.lastTokAt;
+    gState.declaredBefore = &declaredBefore;
+    int line;
+    bool ok = EndProgram(ResumeAt(whole, b, first, line));
+    gState.declaredBefore = nullptr;
+    errors.swap(gState.errors);
+    return ok;
+}
+
+bool CheckProg(istream& in, int& line, vector<Diagnostic>& errors) {
+    bool ok = ParseProgram(in, line);
+    errors.swap(gState.errors);
+    return ok;
+}
+
+bool Prog(std::istream& in, int& line) {
+    if (!ParseProgram(in, line)) {
+        if (!gState.printedErrorsThisCall) {
+            for (size_t i = 0; i < gState.errors.size(); ++i)
+                std::cout << (i + 1) << ". " << FormatError(gState.errors[i], gLines) << std::endl;
+            gState.printedErrorsThisCall = true;
+        }
+        std::cout << "Unsuccessful Parsing" << std::endl;
+        std::cout << "Number of Syntax Errors " << gState.errors.size() << std::endl;
+        return false;
+    }
+
+    // ==== SUCCESS OUTPUT (sorted list) ====
+    std::cout << "Declared Variables:" << std::endl;
+    vector<string> sorted = gState.varOrder;
+    sort(sorted.begin(), sorted.end());
+    if (!sorted.empty()) {
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            std::cout << sorted[i];
+            if (i + 1 < sorted.size()) std::cout << ", ";
+        }
+        std::cout << std::endl;
+    } else {
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+    std::cout << "DONE" << std::endl;
+    return true;
+}
+
+bool StmtList(istream& in, int& line) { return StmtList(in, line, false); }
+
+bool StmtList(istream& in, int& line, bool inIfElseClause) {
+    RULE_SCOPE(R_STMTLIST);
+    size_t from = gState.built.size();
+    if (!Stmt(in, line)) return false;
+
+    if (!Accept(in, line, {SEMICOL})) {
+        // prog3 ends the list at a statement with no ';' after it
+        if (gDialect == DIALECT_PROG3) {
+            Join(N_BLOCK, TokenView(), from);
+            return true;
+        }
+        int reportLine = LineBefore(PeekTok(in, line).offset);
+        gState.lastMissingSemiLine = reportLine;
+        ErrorOnLine(reportLine, E_MISSING_SEMI);
+
+        // Sync ONLY to ';' so '}' remains for braces.
+        RecoverUntil(in, line, {SEMICOL});
+        Accept(in, line, {SEMICOL});
+        return false;
+    }
+
+    if (!StmtTail(in, line, inIfElseClause)) return false;
+    Join(N_BLOCK, TokenView(), from);
+    return true;
+}
+
+// The statements after the first, up to one that does not start a statement
+bool StmtTail(istream& in, int& line, bool inIfElseClause) {
+    RULE_SCOPE(R_STMTTAIL);
+    while (true) {
+        const TokenView& t = PeekTok(in, line);
+
+        if (inIfElseClause && (t.kind == RBRACES || TokIsElse(t))) break;
+
+        if (!inIfElseClause && TokIsElse(t) && gDialect == DIALECT_PROG2) {
+            ParseError(GetTok(in, line).offset, E_ILLEGAL_ELSE);
+            return false;
+        }
+
+        if (!(TokIsIf(t) || TokIsPrint(t) || t.kind == IDENT)) break;
+
+        if (!Stmt(in, line)) return false;
+
+        if (!Accept(in, line, {SEMICOL})) {
+            if (gDialect == DIALECT_PROG3) break;
+            int reportLine = LineBefore(PeekTok(in, line).offset);
+            gState.lastMissingSemiLine = reportLine;
+            ErrorOnLine(reportLine, E_MISSING_SEMI);
+
+            RecoverUntil(in, line, {SEMICOL});
+            Accept(in, line, {SEMICOL});
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Stmt(istream& in, int& line) {
+    RULE_SCOPE(R_STMT);
+    const TokenView& t = PeekTok(in, line);
+
+    if (gDialect == DIALECT_PROG3 && !(TokIsIf(t) || TokIsPrint(t) || t.kind == IDENT)) {
+        ParseError(LastTok(), E_INVALID_STMT);
+        return false;
+    }
+    if (TokIsElse(t)) { ParseError(t.offset, E_ILLEGAL_ELSE); return false; }
+    if (TokIsIf(t))    return IfStmt(in, line);
+    if (TokIsPrint(t)) return PrintLnStmt(in, line);
+    if (t.kind == IDENT) return AssignStmt(in, line);
+
+    ParseError(GetTok(in, line).offset, E_INCORRECT_STMT);
+    return false;
+}
+
+bool PrintLnStmt(istream& in, int& line) {
+    RULE_SCOPE(R_PRINTLN);
+    TokenView kw = GetTok(in, line);
+    size_t from = gState.built.size();
+
+    if (!Expect(in, line, {LPAREN}, E_PRINTLN_MISSING_LP, E_PRINTLN_NO_LP)) {
+        ParseError2(kw.offset, E_PRINTLN_INCORRECT);
+        return false;
+    }
+    if (!ExprList(in, line)) {
+        ParseError2(kw.offset, E_MISSING_OPERAND_FOR);
+        ParseError2(kw.offset, E_PRINTLN_INCORRECT);
+        ParseError3(LastTok(), E_PRINTLN_BAD_LIST);
+        return false;
+    }
+    if (!Accept(in, line, {RPAREN})) {
+        ParseError2(kw.offset, E_PRINTLN_MISSING_RP);
+        ParseError2(kw.offset, E_PRINTLN_INCORRECT);
+        ParseError3(LastTok(), E_PRINTLN_NO_RP);
+        return false;
+    }
+    Join(N_PRINTLN, kw, from);
+    return true;
+}
+
+bool IfStmt(istream& in, int& line) {
+    RULE_SCOPE(R_IF);
+    TokenView kw = GetTok(in, line);
+    size_t from = gState.built.size();
+
+    if (!Accept(in, line, {LPAREN})) {
+        ParseError2(kw.offset, E_IF_MISSING_LP);
+        ParseError2(kw.offset, E_IF_INCORRECT);
+        ParseError3(LastTok(), E_IF_NO_LP);
+        return false;
+    }
+    if (!Expr(in, line)) {
+        ParseError2(kw.offset, E_MISSING_OPERAND_FOR);
+        ParseError2(kw.offset, E_IF_INCORRECT);
+        ParseError3(LastTok(), E_IF_BAD_COND);
+        return false;
+    }
+    if (!Accept(in, line, {RPAREN})) {
+        ParseError2(kw.offset, E_IF_MISSING_RP);
+        ParseError2(kw.offset, E_IF_INCORRECT);
+        ParseError3(LastTok(), E_IF_NO_RP);
+        return false;
+    }
+
+    {
+        unsigned anchor = PeekTok(in, line).offset;
+        if (!Accept(in, line, {LBRACES})) {
+            ParseError2(anchor, E_IF_MISSING_LBRACE);
+            ParseError2(anchor, E_IF_INCORRECT);
+            ParseError3(LastTok(), E_IF_NO_LBRACE);
+            return false;
+        }
+    }
+
+    if (!StmtList(in, line, true)) {
+        ParseError2(kw.offset, E_IF_INCORRECT);
+        return false;
+    }
+
+    {
+        const unsigned needIfRBraceAt = LastTok();
+        if (!Accept(in, line, {RBRACES})) {
+            if (gDialect == DIALECT_PROG3) {
+                ParseError(LastTok(), E_IF_NO_RBRACE);
+                return false;
+            }
+            if (PeekTok(in, line).kind == ELSE) {
+                unsigned elseAt = GetTok(in, line).offset;
+                ParseError(needIfRBraceAt, E_IF_MISSING_RBRACE);
+                ParseError(needIfRBraceAt, E_IF_INCORRECT);
+                ParseError(elseAt,         E_ILLEGAL_ELSE);
+                return false;
+            } else {
+                ParseError(needIfRBraceAt, E_IF_MISSING_RBRACE);
+                ParseError(needIfRBraceAt, E_IF_INCORRECT);
+                return false;
+            }
+        }
+    }
+
+    if (PeekTok(in, line).kind == ELSE) {
+        unsigned elseAt = GetTok(in, line).offset;
+        if (!Accept(in, line, {LBRACES})) {
+            ParseError2(elseAt, E_ELSE_MISSING_LBRACE);
+            ParseError2(elseAt, E_IF_INCORRECT);
+            ParseError3(LastTok(), E_ELSE_NO_LBRACE);
+            return false;
+        }
+        if (!StmtList(in, line, true)) {
+            if (gDialect == DIALECT_PROG2) {
+                int anchor = gState.lastMissingSemiLine ? gState.lastMissingSemiLine : LineBefore(LastTok());
+                ErrorOnLine(anchor, E_MISSING_STMT_ELSE);
+                ErrorOnLine(anchor, E_IF_INCORRECT);
+            }
+            return false;
+        }
+        unsigned needElseRBraceAt = LastTok();
+        if (!Accept(in, line, {RBRACES})) {
+            if (gDialect == DIALECT_PROG2) {
+                ErrorOnLine(LineBefore(needElseRBraceAt), E_ELSE_MISSING_RBRACE);
+                ErrorOnLine(LineBefore(needElseRBraceAt), E_IF_INCORRECT); // <-- anchor to same line
+            }
+            ParseError3(LastTok(), E_ELSE_NO_RBRACE);
+            return false;
+        }
+    }
+
+    Join(N_IF, kw, from);
+    return true;
+}
+
+bool AssignStmt(istream& in, int& line) {
+    RULE_SCOPE(R_ASSIGN);
+    size_t from = gState.built.size();
+    if (!Var(in, line)) return false;
+    if (!AssigOp(in, line)) {
+        ParseError2(LastTok(), E_MISSING_ASSIGN_OP);
+        ParseError2(LastTok(), E_INCORRECT_ASSIGN);
+        ParseError3(LastTok(), E_NO_ASSIGN_OP);
+        return false;
+    }
+    if (!Expr(in, line)) {
+        bool suppressMissingExpr = (gState.emitPairOnce != 0);
+        if (!suppressMissingExpr) ParseError2(LastTok(), E_MISSING_EXPR_IN_ASSIGN);
+        ParseError2(LastTok(), E_INCORRECT_ASSIGN);
+        ParseError3(LastTok(), E_NO_ASSIGN_EXPR);
+        return false;
+    }
+    Join(N_ASSIGN, gState.assignOp, from);
+    return true;
+}
+
+bool Var(istream& in, int& line) {
+    RULE_SCOPE(R_VAR);
+    gState.onAssignLHS = true;
+    TokenView id = GetTok(in, line);
+    gState.onAssignLHS = false;
+
+    if (id.kind != IDENT) {
+        ParseError(id.offset, E_MISSING_VAR_IN_ASSIGN);
+        return false;
+    }
+    DefineVarOnce(Lexeme(id));
+    Leaf(N_IDENT, id);
+    return true;
+}
+
+bool ExprList(istream& in, int& line) {
+    RULE_SCOPE(R_EXPRLIST);
+    if (!Expr(in, line)) return false;
+    while (Accept(in, line, {COMMA})) {
+        if (!Expr(in, line)) return false;
+    }
+    return true;
+}
+
+bool AssigOp(istream& in, int& line) {
+    RULE_SCOPE(R_ASSIGOP);
+    return Accept(in, line, {ASSOP, CADDA, CSUBA, CCATA}, &gState.assignOp);
+}
+
+bool Expr(istream& in, int& line) { RULE_SCOPE(R_EXPR); return OrExpr(in, line); }
+
+bool OrExpr(istream& in, int& line) {
+    RULE_SCOPE(R_OR);
+    size_t from = gState.built.size();
+    if (!AndExpr(in, line)) return false;
+    TokenView op;
+    while (Accept(in, line, {OR}, &op)) {
+        if (!AndExpr(in, line)) {
+            if (MaybeEmitSingle(LastTok())) return false;
+            if (MaybeEmitPair(LastTok()))   return false;
+            ParseError2(LastTok(), E_MISSING_OPERAND_FOR);
+            ParseError2(LastTok(), E_MISSING_OPERAND_AFTER);
+            ParseError3(LastTok(), E_OR_OPERAND);
+            return false;
+        }
+        Join(N_BINARY, op, from);
+    }
+    return true;
+}
+
+bool AndExpr(istream& in, int& line) {
+    RULE_SCOPE(R_AND);
+    size_t from = gState.built.size();
+    if (!RelExpr(in, line)) return false;
+    TokenView op;
+    while (Accept(in, line, {AND}, &op)) {
+        if (!RelExpr(in, line)) {
+            if (MaybeEmitSingle(LastTok())) return false;
+            if (MaybeEmitPair(LastTok()))   return false;
+            ParseError2(LastTok(), E_MISSING_OPERAND_FOR);
+            ParseError2(LastTok(), E_MISSING_OPERAND_AFTER);
+            ParseError3(LastTok(), E_AND_OPERAND);
+            return false;
+        }
+        Join(N_BINARY, op, from);
+    }
+    return true;
+}
+
+bool RelExpr(istream& in, int& line) {
+    RULE_SCOPE(R_REL);
+    size_t from = gState.built.size();
+    if (!AddExpr(in, line)) return false;
+
+    const TokenView& next = PeekTok(in, line);
+    const bool isStringRel  = IsAny(next, {SLTE, SGT, SEQ});
+    const bool isNumericRel = IsNumericRel(next);
+
+    if (isStringRel || isNumericRel) {
+        TokenView t = GetTok(in, line);
+        if (!AddExpr(in, line)) {
+            if (MaybeEmitSingle(t.offset)) return false;
+            if (MaybeEmitPair(t.offset))   return false;
+            ParseError2(t.offset, E_MISSING_OPERAND_FOR);
+            ParseError2(t.offset, E_MISSING_OPERAND_AFTER);
+            ParseError3(LastTok(), E_REL_OPERAND);
+            return false;
+        }
+        Join(N_BINARY, t, from);
+    }
+    return true;
+}
+
+bool AddExpr(istream& in, int& line) {
+    RULE_SCOPE(R_ADD);
+    size_t from = gState.built.size();
+    if (!MultExpr(in, line)) return false;
+    while (true) {
+        if (!IsAny(PeekTok(in, line), {PLUS, MINUS, CAT})) break;
+        TokenView t = GetTok(in, line);
+
+        if (gDialect == DIALECT_PROG2 && !StartsUnary(in, line)) {
+            if (MaybeEmitSingle(t.offset)) return false;
+            if (MaybeEmitPair(t.offset))   return false;
+            ParseError(t.offset, E_MISSING_OPERAND_FOR);
+            ParseError(t.offset, E_MISSING_OPERAND_AFTER);
+            return false;
+        }
+        if (!MultExpr(in, line)) {
+            if (MaybeEmitSingle(t.offset)) return false;
+            if (MaybeEmitPair(t.offset))   return false;
+            ParseError2(t.offset, E_MISSING_OPERAND_FOR);
+            ParseError2(t.offset, E_MISSING_OPERAND_AFTER);
+            ParseError3(LastTok(), E_ADD_OPERAND);
+            return false;
+        }
+        Join(N_BINARY, t, from);
+    }
+    return true;
+}
+
+bool MultExpr(istream& in, int& line) {
+    RULE_SCOPE(R_MULT);
+    size_t from = gState.built.size();
+    if (!UnaryExpr(in, line)) return false;
+    while (true) {
+        if (!IsAny(PeekTok(in, line), {MULT, DIV, REM, SREPEAT})) break;
+        TokenView t = GetTok(in, line);
+
+        if (gDialect == DIALECT_PROG2 && !StartsUnary(in, line)) {
+            if (MaybeEmitSingle(t.offset)) return false;
+            if (MaybeEmitPair(t.offset))   return false;
+            ParseError(t.offset, E_MISSING_OPERAND_FOR);
+            ParseError(t.offset, E_MISSING_OPERAND_AFTER);
+            return false;
+        }
+        if (!UnaryExpr(in, line)) {
+            if (MaybeEmitSingle(t.offset)) return false;
+            if (MaybeEmitPair(t.offset))   return false;
+            ParseError2(t.offset, E_MISSING_OPERAND_FOR);
+            ParseError2(t.offset, E_MISSING_OPERAND_AFTER);
+            ParseError3(LastTok(), E_MULT_OPERAND);
+            return false;
+        }
+        Join(N_BINARY, t, from);
+    }
+    return true;
+}
+
+bool UnaryExpr(istream& in, int& line) {
+    RULE_SCOPE(R_UNARY);
+    int sign = +1;
+    size_t from = gState.built.size();
+    TokenView t;
+    if (IsAny(PeekTok(in, line), {MINUS, PLUS, NOT})) t = GetTok(in, line);
+    bool isNot = t.kind == NOT;
+    if (IsAny(t, {MINUS, PLUS})) { if (t.kind == MINUS) sign = -1; gState.sign = t; }
+    if (!ExponExpr(in, line, sign)) {
+        if (MaybeEmitSingle(LastTok())) return false;
+        if (MaybeEmitPair(LastTok()))   return false;
+        ParseError2(LastTok(), E_MISSING_OPERAND_FOR);
+        ParseError2(LastTok(), E_MISSING_OPERAND_AFTER);
+        return false;
+    }
+    // '!' negates the whole power; a sign went onto its base in ExponExpr
+    if (isNot) Join(N_UNARY, t, from);
+    return true;
+}
+
+bool ExponExpr(istream& in, int& line, int) {
+    RULE_SCOPE(R_EXPON);
+    TokenView sign = gState.sign;
+    gState.sign = TokenView();
+    size_t from = gState.built.size();
+    if (!PrimaryExpr(in, line, +1)) return false;
+    if (sign != ERR) Join(N_UNARY, sign, from);
+    vector<TokenView> ops;
+    TokenView op;
+    int powers = 0;
+    while (Accept(in, line, {EXPONENT}, &op)) {
+        powers++;
+        if (gDialect == DIALECT_PROG3) {
+            // prog3 reads each exponent as a power of its own, so every
+            // '^' so far fails with it
+            if (!PrimaryExpr(in, line, +1)) {
+                while (powers-- > 0) ParseError(LastTok(), E_EXPON_OPERAND);
+                return false;
+            }
+        }
+        else if (!StartsPrimary(in, line) || !PrimaryExpr(in, line, +1)) {
+            ParseError(LastTok(), E_MISSING_EXPONENT);
+            gState.emitPairOnce = 1;
+            return false;
+        }
+        if (gAst) ops.push_back(op);
+    }
+    // right-associative: fold from the last operand back
+    for (size_t i = ops.size(); i-- > 0; )
+        Join(N_BINARY, ops[i], from + i);
+    return true;
+}
+
+bool PrimaryExpr(istream& in, int& line, int) {
+    RULE_SCOPE(R_PRIMARY);
+    TokenView t = GetTok(in, line);
+    Token k = t.kind;
+
+    if (k == IDENT) {
+        if (gDialect == DIALECT_PROG2 && !gState.onAssignLHS && !gState.varSeen.count(Lexeme(t))
+            && !(gState.declaredBefore && (*gState.declaredBefore)(Lexeme(t)))) {
+            ParseError(t.offset, E_UNDEFINED_VAR, Lexeme(t));
+            gState.undefined.push_back(gState.errors.size() - 1);
+        }
+        Leaf(N_IDENT, t);
+        return true;
+    }
+    if (k == ICONST) { Leaf(N_ICONST, t); return true; }
+    if (k == FCONST) { Leaf(N_FCONST, t); return true; }
+    if (k == SCONST) { Leaf(N_SCONST, t); return true; }
+
+    if (k == LPAREN && gDialect == DIALECT_PROG3) {
+        if (!Expr(in, line)) return false;
+        if (!Accept(in, line, {RPAREN})) {
+            ParseError(LastTok(), E_NO_CLOSE_PAREN);
+            return false;
+        }
+        Parens();
+        return true;
+    }
+    if (k == LPAREN) {
+        bool starts = IsAny(PeekTok(in, line), {IDENT, ICONST, FCONST, SCONST, LPAREN, PLUS, MINUS, NOT});
+        if (!starts || !Expr(in, line)) {
+            ParseError(t.offset, E_MISSING_EXPR_IN_PARENS);
+            gState.emitPairOnce = 1;
+            RecoverUntil(in, line, {RPAREN, SEMICOL}); 
+            Accept(in, line, {RPAREN});
+            return false;
+        }
+        if (!Accept(in, line, {RPAREN})) {
+            ParseError(t.offset, E_MISSING_RPAREN);
+            gState.emitSingleOnce = 1;
+            RecoverUntil(in, line, {RPAREN, SEMICOL});
+            Accept(in, line, {RPAREN});
+            return false;
+        }
+        Parens();
+        return true;
+    }
+
+    if (gDialect == DIALECT_PROG3) {
+        ParseError(LastTok(), E_INVALID_PRIMARY);
+        return false;
+    }
+    PushBack(t);
+    return false;
+}
+
+} // namespace bpl
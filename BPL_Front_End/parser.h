@@ -0,0 +1,153 @@
+/* Implementation of Recursive-Descent Parser
+ * for the Basic Perl-Like Language (BPL)
+ * parse.h
+ * CS280
+ * Fall 2025
+*/
+
+#ifndef PARSE_H_
+#define PARSE_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+using namespace std;
+
+#include "lex.h"
+
+class TokenCache;
+class ParallelLexer;
+class Ast;
+
+//The rules and everything else below are in namespace bpl, so a program
+//can link this parser next to code of its own with the same names
+namespace bpl {
+
+extern bool Prog(istream& in, int& line);
+extern bool StmtList(istream& in, int& line);
+extern bool Stmt(istream& in, int& line);
+extern bool PrintLnStmt(istream& in, int& line);
+extern bool IfStmt(istream& in, int& line);
+extern bool AssignStmt(istream& in, int& line);
+extern bool Var(istream& in, int& line);
+extern bool ExprList(istream& in, int& line);
+extern bool Expr(istream& in, int& line);
+extern bool AssigOp(istream& in, int& line);
+extern bool OrExpr(istream& in, int& line);
+extern bool AndExpr(istream& in, int& line);
+extern bool RelExpr(istream& in, int& line);
+extern bool AddExpr(istream& in, int& line);
+extern bool MultExpr(istream& in, int& line);
+extern bool UnaryExpr(istream& in, int& line);
+extern bool ExponExpr(istream& in, int& line, int sign);
+extern bool PrimaryExpr(istream& in, int& line, int sign);
+extern int ErrCount();
+
+//What a syntax error is; FormatError gives the message Prog prints for it
+enum ErrCode : uint8_t {
+	E_MISSING_SEMI, E_MISSING_OPERAND_FOR, E_MISSING_OPERAND_AFTER, E_PROG_BODY,
+	E_MISSING_ASSIGN_OP, E_MISSING_VAR_IN_ASSIGN, E_MISSING_EXPR_IN_ASSIGN, E_INCORRECT_ASSIGN,
+	E_PRINTLN_INCORRECT, E_PRINTLN_MISSING_LP, E_PRINTLN_MISSING_RP,
+	E_IF_INCORRECT, E_IF_MISSING_LP, E_IF_MISSING_RP, E_IF_MISSING_LBRACE, E_IF_MISSING_RBRACE,
+	E_ELSE_MISSING_LBRACE, E_ELSE_MISSING_RBRACE, E_ILLEGAL_ELSE, E_MISSING_STMT_IF, E_MISSING_STMT_ELSE,
+	E_INCORRECT_STMT, E_MISSING_EXPONENT, E_MISSING_EXPR_IN_PARENS, E_MISSING_RPAREN,
+	E_UNDEFINED_VAR,
+	// prog3's, in DIALECT_PROG3
+	E_INVALID_STMT, E_AFTER_END,
+	E_PRINTLN_NO_LP, E_PRINTLN_BAD_LIST, E_PRINTLN_NO_RP,
+	E_IF_NO_LP, E_IF_BAD_COND, E_IF_NO_RP, E_IF_NO_LBRACE, E_IF_NO_RBRACE,
+	E_ELSE_NO_LBRACE, E_ELSE_NO_RBRACE, E_NO_ASSIGN_OP, E_NO_ASSIGN_EXPR,
+	E_OR_OPERAND, E_AND_OPERAND, E_REL_OPERAND, E_ADD_OPERAND, E_MULT_OPERAND, E_EXPON_OPERAND,
+	E_NO_CLOSE_PAREN, E_INVALID_PRIMARY,
+	E_COUNT
+};
+
+//One syntax error as the parser found it. The message is only worded when
+//it is printed.
+struct Diagnostic {
+	ErrCode code;
+	int line;
+	unsigned offset;	// of the last token read, or TokenView::NoOffset
+	string name;	// the variable of E_UNDEFINED_VAR
+};
+
+//"Line N: message", with the column of offset when lines is given
+extern string FormatError(const Diagnostic& d, const LineTable* lines);
+
+//Parse a program as Prog does, printing nothing; errors gets the ones
+//Prog would list
+extern bool CheckProg(istream& in, int& line, vector<Diagnostic>& errors);
+
+//A run of whole top-level statements parsed on its own, as the parallel
+//and incremental parsers stitch them together. A "Using Undefined
+//Variable" error is also listed in undefined: it stands only if no run
+//before this one declared the variable.
+struct StmtRun {
+	vector<Diagnostic> errors;	// as Prog would list them
+	vector<size_t> undefined;	// indexes in errors
+	vector<string> declared;	// in order of first assignment
+	unsigned lastTokAt = TokenView::NoOffset;	// the furthest token looked at
+	bool failed = false;	// a syntax error ended the program's parse here
+	bool reachedEnd = false;	// else a token that starts no statement did
+};
+
+//Points just past each ';' outside braces, strings and comments in [b, e),
+//at most one per step bytes, with b first and e last
+extern vector<const char*> StatementCuts(const char* b, const char* e, size_t step);
+//Parse the statements in [b, e) of whole, which needs a line table; first
+//when b is the start of the program
+extern void ParseStmtRun(const SourceCursor& whole, const char* b, const char* e, bool first, StmtRun& run);
+//Parse from b to the end of whole in order and finish as Prog does, after
+//the statements that left prior; declaredBefore tells whether they
+//declared a variable. errors gets the full list.
+extern bool ResumeProg(const SourceCursor& whole, const char* b, bool first, const StmtRun& prior,
+                       const function<bool(string_view)>& declaredBefore, vector<Diagnostic>& errors);
+
+//The settings below, and the parse state, belong to the calling thread:
+//threads may check different programs at the same time
+//Lex from an in-memory source instead of the istream passed to Prog
+extern void SetTokenSource(SourceCursor* src);
+//Lex from a pipe or stdin, a block at a time
+extern void SetTokenReader(BlockReader* rd);
+//Take the tokens from a cache made by an earlier run instead of lexing
+extern void SetTokenCache(TokenCache* cache);
+//Take the tokens from a source lexed in chunks on worker threads
+extern void SetChunkLexer(ParallelLexer* lexer);
+//Give the column of the last token in error messages
+extern void SetLineTable(const LineTable* lines);
+//Build the syntax tree of the program into ast; left empty on syntax
+//errors, but see DIALECT_PROG3
+extern void SetAstOutput(Ast* ast);
+//Check runs of top-level statements of a large in-memory source on this
+//many threads; 1, the default, parses in order on the calling thread
+extern void SetParseThreads(unsigned threads);
+
+//How Prog parses. ENGINE_LL1 runs the LL(1) table of lltable.h on an
+//explicit stack, so no program deepens the call stack however far it
+//nests. It builds the same tree as the recursive-descent rules and reports
+//the same errors, with the error actions of the table. The parallel parse
+//always uses the rules.
+enum ParseEngine : uint8_t { ENGINE_RD, ENGINE_LL1 };
+extern void SetParseEngine(ParseEngine engine);
+
+//Whose language and messages the parse follows. DIALECT_PROG2 is prog2's:
+//every statement ends with ';', a variable is read only after an
+//assignment to it, and after an error the rules find a place to go on
+//from and report what else they can. DIALECT_PROG3 is prog3's: the last
+//';' of a statement list may be left out, a variable is only checked when
+//the program runs, and "<", ">=" and "==" are the only numeric relations.
+//The parse stops at the first error, which gets one message for each rule
+//it fails out of, and then the source must end. A tree is built even then,
+//of the top-level statements before the one in error.
+enum Dialect : uint8_t { DIALECT_PROG2, DIALECT_PROG3 };
+extern void SetDialect(Dialect dialect);
+
+} // namespace bpl
+
+using namespace bpl;
+
+#endif /* PARSE_H_ */
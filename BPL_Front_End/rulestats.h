@@ -0,0 +1,149 @@
+/*
+ * rulestats.h
+ * Per grammar rule counters for the BPL parsers, built in on request
+ * CS280
+ * Fall 2025
+*/
+
+#ifndef RULESTATS_H_
+#define RULESTATS_H_
+
+//Compiled with -DBPL_RULE_STATS, each rule counts its calls, how deep it
+//recursed and the tokens taken while it ran, its callees' included; the
+//parsers also count the tokens they pushed back and the ones they skipped
+//without parsing (panic-mode recovery in prog2, untaken branches in
+//prog3). The table goes to stderr when the program exits. Without the flag
+//every macro below expands to nothing.
+
+enum Rule {
+	R_PROG, R_STMTLIST, R_STMTTAIL, R_STMT, R_PRINTLN, R_IF, R_ASSIGN, R_VAR,
+	R_EXPRLIST, R_ASSIGOP, R_EXPR, R_OR, R_AND, R_REL, R_ADD, R_MULT,
+	R_UNARY, R_EXPON, R_PRIMARY,
+	R_COUNT
+};
+
+#ifdef BPL_RULE_STATS
+
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+
+namespace rulestats {
+
+typedef unsigned long long u64;
+
+struct Counts {
+	u64	calls[R_COUNT] = {};
+	u64	tokens[R_COUNT] = {};
+	unsigned	maxDepth[R_COUNT] = {};
+	unsigned	maxNesting = 0;	// rules active at once
+	u64	taken = 0;
+	u64	pushedBack = 0;
+	u64	skipped = 0;
+
+	void Add(const Counts& c) {
+		for( int r = 0; r < R_COUNT; r++ ) {
+			calls[r] += c.calls[r];
+			tokens[r] += c.tokens[r];
+			if( c.maxDepth[r] > maxDepth[r] ) maxDepth[r] = c.maxDepth[r];
+		}
+		if( c.maxNesting > maxNesting ) maxNesting = c.maxNesting;
+		taken += c.taken;
+		pushedBack += c.pushedBack;
+		skipped += c.skipped;
+	}
+};
+
+//What every thread has counted, written out at exit
+struct Totals : Counts {
+	mutex	lock;
+
+	~Totals() {
+		static const char* const names[R_COUNT] = {
+			"Prog", "StmtList", "StmtTail", "Stmt", "PrintLnStmt", "IfStmt", "AssignStmt", "Var",
+			"ExprList", "AssigOp", "Expr", "OrExpr", "AndExpr", "RelExpr", "AddExpr", "MultExpr",
+			"UnaryExpr", "ExponExpr", "PrimaryExpr",
+		};
+		u64 most = 1;
+		for( int r = 0; r < R_COUNT; r++ )
+			if( calls[r] > most ) most = calls[r];
+
+		ostream& out = cerr;
+		out << "Grammar rules:" << endl;
+		out << setw(12) << "Rule" << setw(12) << "Calls" << setw(14) << "Tokens"
+			<< setw(12) << "Tok/Call" << setw(10) << "MaxDepth" << "  Calls" << endl;
+		for( int r = 0; r < R_COUNT; r++ ) {
+			if( !calls[r] ) continue;
+			out << setw(12) << names[r] << setw(12) << calls[r] << setw(14) << tokens[r]
+				<< setw(12) << fixed << setprecision(2) << double(tokens[r]) / calls[r]
+				<< setw(10) << maxDepth[r] << "  " << string(size_t(40 * calls[r] / most), '#') << endl;
+		}
+		out << "Tokens taken " << taken << ", pushed back " << pushedBack << ", skipped " << skipped
+			<< "; rules nested " << maxNesting << " deep" << endl;
+	}
+};
+
+inline Totals& AllThreads() {
+	static Totals totals;
+	return totals;
+}
+
+//One thread's counts, added to the totals when the thread ends
+struct ThreadCounts : Counts {
+	unsigned	depth[R_COUNT] = {};
+	unsigned	nesting = 0;
+
+	ThreadCounts() { AllThreads(); }	// built first, so destroyed last
+	~ThreadCounts() {
+		Totals& t = AllThreads();
+		lock_guard<mutex> hold(t.lock);
+		t.Add(*this);
+	}
+};
+
+inline ThreadCounts& Mine() {
+	static thread_local ThreadCounts counts;
+	return counts;
+}
+
+//Counts one call of a rule, for as long as it runs
+class Scope {
+	Rule	rule;
+	u64	takenBefore;
+
+public:
+	explicit Scope(Rule r) : rule(r) {
+		ThreadCounts& c = Mine();
+		c.calls[r]++;
+		if( ++c.depth[r] > c.maxDepth[r] ) c.maxDepth[r] = c.depth[r];
+		if( ++c.nesting > c.maxNesting ) c.maxNesting = c.nesting;
+		takenBefore = c.taken;
+	}
+	~Scope() {
+		ThreadCounts& c = Mine();
+		c.tokens[rule] += c.taken - takenBefore;
+		c.depth[rule]--;
+		c.nesting--;
+	}
+	Scope(const Scope&) = delete;
+	Scope& operator=(const Scope&) = delete;
+};
+
+} // namespace rulestats
+
+#define RULE_SCOPE(r)	rulestats::Scope ruleScope_(r)
+#define RULE_TOKEN()	(rulestats::Mine().taken++)
+#define RULE_PUSHBACK()	(rulestats::Mine().pushedBack++)
+#define RULE_SKIP()	(rulestats::Mine().skipped++)
+
+#else
+
+#define RULE_SCOPE(r)
+#define RULE_TOKEN()
+#define RULE_PUSHBACK()
+#define RULE_SKIP()
+
+#endif /* BPL_RULE_STATS */
+
+#endif /* RULESTATS_H_ */
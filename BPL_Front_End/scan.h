@@ -0,0 +1,184 @@
+/*
+ * scan.h
+ * Bulk character-class scanning for the BPL lexers
+ * CS280
+ * Fall 2025
+*/
+
+#ifndef SCAN_H_
+#define SCAN_H_
+
+#include <cstddef>
+#include <vector>
+
+//Each scanner takes a range [p, end) and returns a pointer to the first byte
+//that ends the run, or end. With SSE2 or AVX2 they classify 16 or 32 bytes
+//per step; the scalar loop finishes the tail and is the fallback elsewhere.
+//Classes follow the C locale: bytes >= 0x80 are never space, letter or digit.
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SCAN_SIMD 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SCAN_SIMD 1
+#endif
+
+namespace scan {
+
+inline bool IsSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+inline bool IsIdent(char c) {
+	char l = c | 0x20;
+	return (l >= 'a' && l <= 'z') || IsDigit(c) || c == '_' || c == '$';
+}
+
+#if defined(__AVX2__)
+typedef __m256i Vec;
+const size_t Width = 32;
+const unsigned Full = 0xFFFFFFFFu;
+inline Vec Load(const char* p) { return _mm256_loadu_si256((const __m256i*)p); }
+inline Vec Splat(char c) { return _mm256_set1_epi8(c); }
+inline Vec Eq(Vec a, char c) { return _mm256_cmpeq_epi8(a, Splat(c)); }
+inline Vec Or(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+inline Vec And(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+inline Vec Gt(Vec a, Vec b) { return _mm256_cmpgt_epi8(a, b); }
+inline unsigned Mask(Vec v) { return (unsigned)_mm256_movemask_epi8(v); }
+#elif defined(__SSE2__)
+typedef __m128i Vec;
+const size_t Width = 16;
+const unsigned Full = 0xFFFFu;
+inline Vec Load(const char* p) { return _mm_loadu_si128((const __m128i*)p); }
+inline Vec Splat(char c) { return _mm_set1_epi8(c); }
+inline Vec Eq(Vec a, char c) { return _mm_cmpeq_epi8(a, Splat(c)); }
+inline Vec Or(Vec a, Vec b) { return _mm_or_si128(a, b); }
+inline Vec And(Vec a, Vec b) { return _mm_and_si128(a, b); }
+inline Vec Gt(Vec a, Vec b) { return _mm_cmpgt_epi8(a, b); }
+inline unsigned Mask(Vec v) { return (unsigned)_mm_movemask_epi8(v); }
+#endif
+
+#ifdef SCAN_SIMD
+//lo <= v <= hi for ASCII bounds; the signed compare keeps bytes >= 0x80 out
+inline Vec InRange(Vec v, char lo, char hi) {
+	return And(Gt(v, Splat(lo - 1)), Gt(Splat(hi + 1), v));
+}
+
+inline Vec SpaceMask(Vec v) { return Or(Eq(v, ' '), InRange(v, '\t', '\r')); }
+inline Vec DigitMask(Vec v) { return InRange(v, '0', '9'); }
+inline Vec IdentMask(Vec v) {
+	return Or(Or(InRange(Or(v, Splat(0x20)), 'a', 'z'), DigitMask(v)), Or(Eq(v, '_'), Eq(v, '$')));
+}
+#endif
+
+//Whitespace run; adds the newlines it passes to lines
+inline const char* SkipSpace(const char* p, const char* end, int& lines)
+{
+#ifdef SCAN_SIMD
+	while( end - p >= (ptrdiff_t)Width ) {
+		Vec v = Load(p);
+		unsigned nl = Mask(Eq(v, '\n'));
+		unsigned stop = ~Mask(SpaceMask(v)) & Full;
+		if( stop ) {
+			unsigned k = __builtin_ctz(stop);
+			lines += __builtin_popcount(nl & ((1u << k) - 1));
+			return p + k;
+		}
+		lines += __builtin_popcount(nl);
+		p += Width;
+	}
+#endif
+	for( ; p < end && IsSpace(*p); p++ )
+		if( *p == '\n' ) lines++;
+	return p;
+}
+//The same, for a lexer that keeps no line
+inline const char* SkipSpace(const char* p, const char* end)
+{
+#ifdef SCAN_SIMD
+	while( end - p >= (ptrdiff_t)Width ) {
+		unsigned stop = ~Mask(SpaceMask(Load(p))) & Full;
+		if( stop ) return p + __builtin_ctz(stop);
+		p += Width;
+	}
+#endif
+	while( p < end && IsSpace(*p) ) p++;
+	return p;
+}
+
+inline const char* SkipDigits(const char* p, const char* end)
+{
+#ifdef SCAN_SIMD
+	while( end - p >= (ptrdiff_t)Width ) {
+		unsigned stop = ~Mask(DigitMask(Load(p))) & Full;
+		if( stop ) return p + __builtin_ctz(stop);
+		p += Width;
+	}
+#endif
+	while( p < end && IsDigit(*p) ) p++;
+	return p;
+}
+
+//Letters, digits, '_' and '$'
+inline const char* SkipIdent(const char* p, const char* end)
+{
+#ifdef SCAN_SIMD
+	while( end - p >= (ptrdiff_t)Width ) {
+		unsigned stop = ~Mask(IdentMask(Load(p))) & Full;
+		if( stop ) return p + __builtin_ctz(stop);
+		p += Width;
+	}
+#endif
+	while( p < end && IsIdent(*p) ) p++;
+	return p;
+}
+
+//First byte equal to a, b or c: comment and string bodies
+inline const char* FindByte(const char* p, const char* end, char a, char b, char c)
+{
+#ifdef SCAN_SIMD
+	while( end - p >= (ptrdiff_t)Width ) {
+		Vec v = Load(p);
+		unsigned hit = Mask(Or(Or(Eq(v, a), Eq(v, b)), Eq(v, c)));
+		if( hit ) return p + __builtin_ctz(hit);
+		p += Width;
+	}
+#endif
+	while( p < end && *p != a && *p != b && *p != c ) p++;
+	return p;
+}
+
+//First byte equal to any of seven: the statement pre-scan's stop bytes
+inline const char* FindByte(const char* p, const char* end, char a, char b, char c, char d, char e, char f, char g)
+{
+#ifdef SCAN_SIMD
+	while( end - p >= (ptrdiff_t)Width ) {
+		Vec v = Load(p);
+		unsigned hit = Mask(Or(Or(Or(Eq(v, a), Eq(v, b)), Or(Eq(v, c), Eq(v, d))), Or(Or(Eq(v, e), Eq(v, f)), Eq(v, g))));
+		if( hit ) return p + __builtin_ctz(hit);
+		p += Width;
+	}
+#endif
+	while( p < end && *p != a && *p != b && *p != c && *p != d && *p != e && *p != f && *p != g ) p++;
+	return p;
+}
+
+//Offset from base of the byte after each newline: where the next line starts
+inline void LineStarts(const char* p, const char* end, const char* base, std::vector<unsigned>& out)
+{
+#ifdef SCAN_SIMD
+	while( end - p >= (ptrdiff_t)Width ) {
+		unsigned nl = Mask(Eq(Load(p), '\n'));
+		while( nl ) {
+			out.push_back(unsigned(p - base) + __builtin_ctz(nl) + 1);
+			nl &= nl - 1;
+		}
+		p += Width;
+	}
+#endif
+	for( ; p < end; p++ )
+		if( *p == '\n' ) out.push_back(unsigned(p - base) + 1);
+}
+
+} // namespace scan
+
+#endif /* SCAN_H_ */
@@ -0,0 +1,172 @@
+/*
+ * tokcache.cpp
+ *
+ * CS280 - Fall 2025
+ * Binary token stream of a BPL source, saved for later runs
+ */
+
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "tokcache.h"
+
+namespace {
+
+const char Magic[8] = { 'B', 'P', 'L', 'T', 'O', 'K', 'S', '2' };
+
+//File layout: this header, count TokenRecords, the last one DONE, and then
+//numberCount doubles
+struct Header {
+	char	magic[8];
+	uint32_t	recordSize;
+	uint32_t	reserved;
+	uint64_t	sourceSize;
+	uint64_t	sourceHash;
+	uint64_t	count;
+	uint64_t	numberCount;
+};
+
+bool IsNumber(uint32_t token) { return token == ICONST || token == FCONST; }
+
+} // namespace
+
+TokenCache::TokenCache(const SourceBuffer& src)
+	: src(src), mapping(nullptr), mapSize(0), recs(nullptr), numbers(nullptr),
+	  count(0), numberCount(0), idx(0), numberIdx(0)
+{
+}
+
+TokenCache::~TokenCache()
+{
+	Unmap();
+}
+
+void TokenCache::Unmap()
+{
+	if( mapping )
+		munmap(mapping, mapSize);
+	mapping = nullptr;
+	mapSize = 0;
+}
+
+bool TokenCache::Load(const string& path)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if( fd < 0 )
+		return false;
+
+	struct stat st;
+	void* p = MAP_FAILED;
+	if( fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && (size_t)st.st_size > sizeof(Header) )
+		p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if( p == MAP_FAILED )
+		return false;
+
+	Unmap();
+	mapping = p;
+	mapSize = st.st_size;
+
+	const Header* h = (const Header*)p;
+	const TokenRecord* r = (const TokenRecord*)(h + 1);
+	size_t body = mapSize - sizeof(Header);
+	bool ok = memcmp(h->magic, Magic, sizeof(Magic)) == 0
+		&& h->recordSize == sizeof(TokenRecord)
+		&& h->count > 0 && h->count <= body / sizeof(TokenRecord)
+		&& h->numberCount == (body - h->count * sizeof(TokenRecord)) / sizeof(double)
+		&& body == h->count * sizeof(TokenRecord) + h->numberCount * sizeof(double)
+		&& h->sourceSize == src.Size()
+		&& r[h->count - 1].token == DONE
+		&& h->sourceHash == SourceHash(src.Begin(), src.Size());
+
+	//every lexeme must lie inside the source, and every number be there
+	uint64_t n = 0;
+	for( uint64_t i = 0; ok && i < h->count; i++ ) {
+		ok = r[i].token <= DONE && r[i].offset <= src.Size()
+			&& r[i].length <= src.Size() - r[i].offset - (r[i].token == SCONST ? 1 : 0);
+		n += IsNumber(r[i].token);
+	}
+	ok = ok && n == h->numberCount;
+
+	if( !ok ) {
+		Unmap();
+		return false;
+	}
+	built.clear();
+	builtNumbers.clear();
+	recs = r;
+	count = h->count;
+	numbers = (const double*)(r + count);
+	numberCount = h->numberCount;
+	idx = numberIdx = 0;
+	return true;
+}
+
+bool TokenCache::Build()
+{
+	if( src.Size() >= TokenView::NoOffset )
+		return false;
+
+	Unmap();
+	built.clear();
+	builtNumbers.clear();
+	built.reserve(src.Size() / 4 + 1);
+	SourceCursor in(src);
+	while( true ) {
+		TokenView t = getNextToken(in);
+		built.push_back(TokenRecord{ uint32_t(t.kind), t.offset, t.length });
+		if( IsNumber(t.kind) )
+			builtNumbers.push_back(t.number);
+		if( t == DONE )
+			break;
+	}
+	recs = built.data();
+	count = built.size();
+	numbers = builtNumbers.data();
+	numberCount = builtNumbers.size();
+	idx = numberIdx = 0;
+	return true;
+}
+
+bool TokenCache::Save(const string& path) const
+{
+	if( count == 0 )
+		return false;
+
+	Header h;
+	memcpy(h.magic, Magic, sizeof(Magic));
+	h.recordSize = sizeof(TokenRecord);
+	h.reserved = 0;
+	h.sourceSize = src.Size();
+	h.sourceHash = SourceHash(src.Begin(), src.Size());
+	h.count = count;
+	h.numberCount = numberCount;
+
+	//written aside and renamed, so a concurrent Load sees the old file or the new
+	string tmp = path + ".tmp";
+	FILE* f = fopen(tmp.c_str(), "wb");
+	if( !f )
+		return false;
+	bool ok = fwrite(&h, sizeof(h), 1, f) == 1
+		&& fwrite(recs, sizeof(TokenRecord), count, f) == count
+		&& fwrite(numbers, sizeof(double), numberCount, f) == numberCount;
+	ok = fclose(f) == 0 && ok;
+	if( ok && rename(tmp.c_str(), path.c_str()) == 0 )
+		return true;
+	remove(tmp.c_str());
+	return false;
+}
+
+TokenView TokenCache::Next()
+{
+	const TokenRecord& r = recs[idx];
+	//DONE stays the answer once the stream is used up
+	if( idx + 1 < count )
+		idx++;
+	double value = IsNumber(r.token) ? numbers[numberIdx++] : 0;
+	return TokenView(Token(r.token), r.offset, r.length, value);
+}
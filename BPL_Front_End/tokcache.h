@@ -0,0 +1,68 @@
+/*
+ * tokcache.h
+ * Binary token stream of a BPL source, saved for later runs
+ * CS280
+ * Fall 2025
+*/
+
+#ifndef TOKCACHE_H_
+#define TOKCACHE_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+#include "lex.h"
+
+//One token, as written to the cache file. Lexemes are not copied: offset is
+//the token's first byte in the source and an SCONST's lexeme starts one byte
+//after it, past the quote. The values of ICONST and FCONST tokens follow the
+//records, in the same order, as doubles.
+struct TokenRecord {
+	uint32_t	token;
+	uint32_t	offset;
+	uint32_t	length;	// of the lexeme
+};
+
+//The tokens of a whole SourceBuffer, ending with DONE. Load maps a file
+//written by an earlier run, of prog2 or prog3, if it was made from the same
+//bytes; otherwise Build lexes the source once and Save writes that file.
+//Either way Next then hands out the tokens without lexing, numbers
+//included.
+class TokenCache {
+	const SourceBuffer&	src;
+	void*	mapping;
+	size_t	mapSize;
+	vector<TokenRecord>	built;
+	vector<double>	builtNumbers;
+	const TokenRecord*	recs;
+	const double*	numbers;
+	size_t	count;
+	size_t	numberCount;
+	size_t	idx;
+	size_t	numberIdx;
+
+	void	Unmap();
+
+public:
+	explicit TokenCache(const SourceBuffer& src);
+	~TokenCache();
+	TokenCache(const TokenCache&) = delete;
+	TokenCache& operator=(const TokenCache&) = delete;
+
+	//False if path is missing, damaged or was made from another source
+	bool	Load(const string& path);
+	//Lexes the source; false if it is too big for 32-bit offsets
+	bool	Build();
+	//Writes the tokens for the next run, replacing path in one step
+	bool	Save(const string& path) const;
+
+	TokenView	Next();
+	//The source the tokens are views of, and its line table
+	const char*	Begin() const { return src.Begin(); }
+	const LineTable*	Lines() const { return src.Lines(); }
+};
+
+#endif /* TOKCACHE_H_ */
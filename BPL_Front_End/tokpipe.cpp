@@ -0,0 +1,79 @@
+/*
+ * tokpipe.cpp
+ * Lexer thread feeding an interpreter through a bounded token ring
+ * CS280
+ * Fall 2025
+ */
+
+#include "tokpipe.h"
+
+TokenPipe::TokenPipe(BlockReader& reader, int line, size_t capacity, size_t batch)
+	: reader(&reader), lexLine(line), batch(batch), head(0), tail(0), knownHead(0), stop(false)
+{
+	size_t cap = 2;
+	while (cap < capacity) cap <<= 1;
+	ring.resize(cap);
+	mask = cap - 1;
+	if (this->batch == 0 || this->batch > cap) this->batch = cap;
+
+	worker = thread(&TokenPipe::Produce, this);
+}
+
+TokenPipe::~TokenPipe()
+{
+	stop.store(true, memory_order_relaxed);
+	worker.join();
+}
+
+void TokenPipe::Produce()
+{
+	size_t h = head.load(memory_order_relaxed);
+	size_t knownTail = tail.load(memory_order_acquire);
+	size_t n = 0;
+	bool done = false;
+
+	//tokens lexed so far go out before the reader waits on a slow pipe
+	reader->beforeRead = [&] { head.store(h + n, memory_order_release); };
+
+	while (!done) {
+		//wait for room; this is the back-pressure on the lexer
+		while (h - knownTail == ring.size()) {
+			if (stop.load(memory_order_relaxed)) { reader->beforeRead = nullptr; return; }
+			this_thread::yield();
+			knownTail = tail.load(memory_order_acquire);
+		}
+
+		//fill up to one batch
+		size_t room = ring.size() - (h - knownTail);
+		n = 0;
+		while (n < room && n < batch) {
+			LexItem& t = ring[(h + n) & mask];
+			t = getNextToken(*reader, lexLine);
+			n++;
+			if (t.GetToken() == DONE) { done = true; break; }
+		}
+
+		h += n;
+		n = 0;
+		head.store(h, memory_order_release);
+	}
+	reader->beforeRead = nullptr;
+}
+
+LexItem TokenPipe::Pop(int& line)
+{
+	size_t t = tail.load(memory_order_relaxed);
+	while (t == knownHead) {
+		knownHead = head.load(memory_order_acquire);
+		if (t == knownHead) this_thread::yield();
+	}
+
+	LexItem tok = ring[t & mask];
+
+	//after DONE the producer has stopped; leave it in place so that later
+	//calls keep answering DONE like getNextToken does
+	if (tok.GetToken() != DONE) tail.store(t + 1, memory_order_release);
+
+	line = tok.GetLinenum();
+	return tok;
+}
@@ -0,0 +1,53 @@
+/*
+ * tokpipe.h
+ * Lexer thread feeding an interpreter through a bounded token ring
+ * CS280
+ * Fall 2025
+*/
+
+#ifndef TOKPIPE_H_
+#define TOKPIPE_H_
+
+#include <vector>
+#include <atomic>
+#include <thread>
+
+using namespace std;
+
+#include "lex.h"
+
+//Single-producer/single-consumer ring of LexItems. A background thread
+//reads the input through a BlockReader, lexes it and publishes the tokens
+//in batches, and whatever it has before each read; Pop hands them over in
+//order. Reading and lexing thus go on
+//while the consumer runs what it has. The producer blocks while the ring is
+//full and stops after DONE. Pushback stays with the consumer, above the
+//ring.
+class TokenPipe {
+	BlockReader* reader;
+	int lexLine;
+	vector<LexItem> ring;
+	size_t mask;
+	size_t batch;
+
+	alignas(64) atomic<size_t> head;    // next slot the producer fills
+	alignas(64) atomic<size_t> tail;    // next slot the consumer reads
+	alignas(64) size_t knownHead;       // consumer's last view of head
+	atomic<bool> stop;
+	thread worker;
+
+	void Produce();
+
+public:
+	//capacity is rounded up to a power of two; line is the first line's
+	TokenPipe(BlockReader& reader, int line, size_t capacity = 4096, size_t batch = 64);
+	~TokenPipe();
+
+	TokenPipe(const TokenPipe&) = delete;
+	TokenPipe& operator=(const TokenPipe&) = delete;
+
+	//Next token; sets line the way getNextToken would have
+	LexItem Pop(int& line);
+};
+
+#endif /* TOKPIPE_H_ */
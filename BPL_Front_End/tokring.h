@@ -0,0 +1,84 @@
+/*
+ * tokring.h
+ * Lookahead ring between a BPL lexer and a recursive-descent parser
+ * CS280
+ * Fall 2025
+*/
+
+#ifndef TOKRING_H_
+#define TOKRING_H_
+
+#include <cstddef>
+
+using namespace std;
+
+#include "lex.h"
+
+//Tokens lexed ahead of a parser, a batch at a time. Get takes the next one,
+//PushBack gives taken ones back, several deep, and Peek(k) looks k tokens
+//ahead without taking or copying any. The lexer is any callable
+//TokenView().
+//
+//Batching does not show in Seen: a token counts as lexed when it is first
+//looked at.
+class TokenRing {
+public:
+	static const size_t MaxPeek = 4;
+	//MaxPeek ahead plus as many taken, so the ones PushBack returns are
+	//still in their slots; no others are kept
+	static const size_t Size = 2 * MaxPeek;
+
+private:
+	TokenView	slots[Size];
+	size_t	head;	// next to take
+	size_t	tail;	// past the last one lexed
+	size_t	seen;	// past the furthest one looked at
+
+	TokenView&	At(size_t i) { return slots[i % Size]; }
+	const TokenView&	At(size_t i) const { return slots[i % Size]; }
+
+	//lexes until token i is in the ring, and a batch ahead of it unless
+	//the source is done
+	template<class Lex> void Fill(size_t i, Lex& lex) {
+		while( tail <= i || (tail < head + MaxPeek && At(tail - 1) != DONE) )
+			At(tail++) = lex();
+	}
+
+public:
+	TokenRing() : head(0), tail(0), seen(0) {}
+
+	//Forgets every token, for a parse that starts elsewhere
+	void	Clear() { head = tail = seen = 0; }
+
+	//The k-th token ahead, 1 <= k <= MaxPeek; valid until the next call
+	template<class Lex> const TokenView& Peek(size_t k, Lex&& lex) {
+		size_t i = head + k - 1;
+		if( i >= tail )
+			Fill(i, lex);
+		if( i >= seen )
+			seen = i + 1;
+		return At(i);
+	}
+	template<class Lex> const TokenView& Get(Lex&& lex) {
+		const TokenView& t = Peek(1, lex);
+		head++;
+		return t;
+	}
+	//Gives back the last token taken, as t; false if PushBack has already
+	//given back all that the ring keeps
+	bool	PushBack(const TokenView& t) {
+		if( head == 0 || tail - head >= Size )
+			return false;
+		TokenView& s = At(--head);
+		if( &s != &t )
+			s = t;
+		return true;
+	}
+
+	//The next token if it has been looked at, else nullptr; lexes nothing
+	const TokenView*	Next() const { return head < seen ? &At(head) : nullptr; }
+	//How many tokens have been looked at for the first time
+	size_t	Seen() const { return seen; }
+};
+
+#endif /* TOKRING_H_ */
@@ -0,0 +1,69 @@
+/*
+ * workpool.cpp
+ * Worker threads shared by the parallel parts of the BPL tools
+ * CS280
+ * Fall 2025
+ */
+
+#include <atomic>
+#include <algorithm>
+
+#include "workpool.h"
+
+WorkPool& WorkPool::Shared()
+{
+	static WorkPool pool;
+	return pool;
+}
+
+WorkPool::~WorkPool()
+{
+	{
+		lock_guard<mutex> hold(lock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for( thread& t : workers )
+		t.join();
+}
+
+void WorkPool::Reserve(unsigned n)
+{
+	lock_guard<mutex> hold(lock);
+	while( workers.size() < n )
+		workers.emplace_back(&WorkPool::Work, this);
+}
+
+void WorkPool::Work()
+{
+	while( true ) {
+		function<void()> task;
+		{
+			unique_lock<mutex> hold(lock);
+			wake.wait(hold, [this] { return stopping || !tasks.empty(); });
+			if( tasks.empty() )
+				return;
+			task = move(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+	}
+}
+
+void WorkPool::ForEach(size_t n, unsigned threads, const function<void(size_t)>& work)
+{
+	atomic<size_t> next(0);
+	auto loop = [&] {
+		for( size_t i; (i = next.fetch_add(1)) < n; )
+			work(i);
+	};
+
+	threads = unsigned(max<size_t>(1, min<size_t>(threads, n)));
+	Reserve(threads - 1);
+	vector<future<void>> helpers;
+	for( unsigned t = 1; t < threads; t++ )
+		helpers.push_back(Submit(loop));
+	loop();
+	for( future<void>& h : helpers )
+		h.get();
+}
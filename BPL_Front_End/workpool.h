@@ -0,0 +1,64 @@
+/*
+ * workpool.h
+ * Worker threads shared by the parallel parts of the BPL tools
+ * CS280
+ * Fall 2025
+*/
+
+#ifndef WORKPOOL_H_
+#define WORKPOOL_H_
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+//Threads started once and kept for the life of the program, so the chunks
+//of a parallel parse or lex and the files of a batch check do not each start
+//one. Workers take tasks in the order they were queued. A task must not wait
+//on another task: it could be queued behind the one waiting.
+class WorkPool {
+	mutex	lock;
+	condition_variable	wake;
+	deque<function<void()>>	tasks;
+	vector<thread>	workers;
+	bool	stopping;
+
+	void	Work();
+
+public:
+	WorkPool() : stopping(false) {}
+	~WorkPool();
+	WorkPool(const WorkPool&) = delete;
+	WorkPool& operator=(const WorkPool&) = delete;
+
+	//The program's pool, with no workers until something reserves them
+	static WorkPool&	Shared();
+
+	//Starts workers until there are at least n
+	void	Reserve(unsigned n);
+
+	//Queues f() for the next free worker; the future gives its result
+	template<class F> auto Submit(F f) -> future<decltype(f())> {
+		auto task = make_shared<packaged_task<decltype(f())()>>(move(f));
+		future<decltype(f())> result = task->get_future();
+		{
+			lock_guard<mutex> hold(lock);
+			tasks.push_back([task] { (*task)(); });
+		}
+		wake.notify_one();
+		return result;
+	}
+
+	//Calls work(i) for every i < n, on the calling thread and up to
+	//threads - 1 workers, each taking the next i until none are left
+	void	ForEach(size_t n, unsigned threads, const function<void(size_t)>& work);
+};
+
+#endif /* WORKPOOL_H_ */
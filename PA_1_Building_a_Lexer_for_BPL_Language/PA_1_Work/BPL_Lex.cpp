@@ -9,6 +9,11 @@
 #include <iomanip>
 #include <cmath>
 #include <set>
+#include <deque>
+#include <future>
+#include <thread>
+#include "scan.h"
+#include "workpool.h"
 using namespace std;
 
 enum class TokenType {
@@ -36,6 +41,13 @@ static string toLowerStr(string v){
     return v;
 }
 
+// case-insensitive compare against a lowercase keyword, without copying
+static bool sameNoCase(const string& s, size_t start, size_t len, const char* kw){
+    for (size_t i = 0; i < len; i++)
+        if (kw[i] == '\0' || tolower((unsigned char)s[start + i]) != kw[i]) return false;
+    return kw[len] == '\0';
+}
+
 static string fmtNumber(double x) {
     long long r = llround(x);
     if (fabs(x - (double)r) < 1e-12) {
@@ -54,32 +66,37 @@ static string fmtNumber(double x) {
 }
 
 class Lexer {
-    string s;
+    const string &s;
     size_t pos;
+    size_t end;
     int line;
     bool errorFlag = false;
 
     char peek(int ahead = 0) const {
-        return (pos + ahead < s.size()) ? s[pos + ahead] : '\0';
+        return (pos + ahead < end) ? s[pos + ahead] : '\0';
     }
-    void advance(int n=1) { while(n-- > 0 && pos < s.size()) pos++; }
+    void advance(int n=1) { while(n-- > 0 && pos < end) pos++; }
+
+    // bulk scanning over the rest of the source
+    const char* here() const { return s.data() + pos; }
+    const char* stop() const { return s.data() + end; }
+    void jump(const char* p) { pos = p - s.data(); }
 
     Token make(TokenType t, const string &lex) { return {t, lex, line}; }
     Token errTok(const string &lex, int ln) { errorFlag = true; return {TokenType::ERR, lex, ln}; }
 
 public:
-    Lexer(const string &src) : s(src), pos(0), line(1) {}
+    Lexer(const string &src) : s(src), pos(0), end(src.size()), line(1) {}
+    // lexes only src[from, to), counting lines from line
+    Lexer(const string &src, size_t from, size_t to, int line) : s(src), pos(from), end(to), line(line) {}
 
     Token next() {
         if (errorFlag) return make(TokenType::END, "");
 
-        while (isspace((unsigned char)peek())) {
-            if (peek() == '\n') line++;
-            advance();
-        }
+        jump(scan::SkipSpace(here(), stop(), line));
 
         if (peek() == '#') {
-            while (peek() != '\n' && peek() != '\0') advance();
+            jump(scan::FindByte(here(), stop(), '\n', '\0', '\n'));
             return next();
         }
 
@@ -92,13 +109,13 @@ public:
             int start_line = line;
             bool hasDot = false;
 
-            while (isdigit((unsigned char)peek())) { advance(); }
+            jump(scan::SkipDigits(here(), stop()));
 
             if (peek() == '.') {
                 if (isdigit((unsigned char)peek(1))) {
                     hasDot = true;
                     advance();
-                    while (isdigit((unsigned char)peek())) advance();
+                    jump(scan::SkipDigits(here(), stop()));
                 } else {
                     string intpart = s.substr(start, pos - start);
                     return make(TokenType::FCONST, intpart);
@@ -112,7 +129,7 @@ public:
                 if (!isdigit((unsigned char)peek())) {
                     pos = save;
                 } else {
-                    while (isdigit((unsigned char)peek())) advance();
+                    jump(scan::SkipDigits(here(), stop()));
                 }
             }
 
@@ -132,16 +149,15 @@ public:
         if (isalpha((unsigned char)c) || c == '$') {
             size_t start = pos;
             advance();
-            while (isalnum((unsigned char)peek()) || peek() == '_' || peek() == '$')
-                advance();
-            string lex = s.substr(start, pos - start);
-
-            string low = toLowerStr(lex);
-            if (low == "if")       return make(TokenType::IFKW, lex);
-            if (low == "else")     return make(TokenType::ELSEKW, lex);
-            if (low == "println")  return make(TokenType::PRINTLNKW, lex);
-
-            return make(TokenType::IDENT, lex);
+            jump(scan::SkipIdent(here(), stop()));
+            size_t len = pos - start;
+            TokenType kw = TokenType::IDENT;
+            switch (len) {
+                case 2: if (sameNoCase(s, start, len, "if"))      kw = TokenType::IFKW; break;
+                case 4: if (sameNoCase(s, start, len, "else"))    kw = TokenType::ELSEKW; break;
+                case 7: if (sameNoCase(s, start, len, "println")) kw = TokenType::PRINTLNKW; break;
+            }
+            return make(kw, s.substr(start, len));
         }
 
         
@@ -151,7 +167,7 @@ public:
                 size_t open = pos;
                 advance();
                 size_t start = pos;
-                while (peek() != '>' && peek() != '\0' && peek() != '\n') advance();
+                jump(scan::FindByte(here(), stop(), '>', '\0', '\n'));
                 if (peek() == '>') {
                     string val = s.substr(start, pos - start);
                     advance();
@@ -172,7 +188,7 @@ public:
             size_t open = pos;
             advance();
             size_t start = pos;
-            while (peek() != '"' && peek() != '\0' && peek() != '\n') advance();
+            jump(scan::FindByte(here(), stop(), '"', '\0', '\n'));
             if (peek() == '"') {
                 string val = s.substr(start, pos - start);
                 advance();
@@ -189,7 +205,7 @@ public:
             size_t open = pos;
             advance();
             size_t start = pos;
-            while (peek() != '\'' && peek() != '\0' && peek() != '\n') advance();
+            jump(scan::FindByte(here(), stop(), '\'', '\0', '\n'));
             if (peek() == '\'') {
                 string val = s.substr(start, pos - start);
                 advance();
@@ -307,6 +323,82 @@ public:
     }
 
     int getLine() const { return line; }
+    bool atEnd() const { return pos >= end; }
+};
+
+// Lexes large sources on several threads. The source is cut into chunks
+// that start right after a newline; no BPL token, string or comment spans a
+// newline, so each chunk lexes on its own from the start state. Chunks count
+// lines from 0 and next() adds the lines of the chunks before, so tokens
+// come out exactly as one Lexer over the whole source would give them.
+class ParallelLexer {
+    struct Lexed {
+        vector<Token> toks;
+        int lines = 0;
+        bool stopped = false;   // ended on ERR or before the chunk end
+    };
+
+    const string &s;
+    size_t nextChunk = 0;
+    size_t chunkSize;
+    size_t window;
+    deque<future<Lexed>> pending;
+    Lexed cur;
+    size_t idx = 0;
+    int base = 1;
+
+    static Lexed lexChunk(const string &src, size_t from, size_t to) {
+        Lexer lex(src, from, to, 0);
+        Lexed out;
+        Token t;
+        while ((t = lex.next()).type != TokenType::END) {
+            out.toks.push_back(t);
+            if (t.type == TokenType::ERR) break;
+        }
+        out.lines = lex.getLine();
+        out.stopped = !out.toks.empty() && out.toks.back().type == TokenType::ERR;
+        out.stopped = out.stopped || !lex.atEnd();
+        return out;
+    }
+
+    void launch() {
+        size_t from = nextChunk, to = s.size();
+        if (to - from > chunkSize) {
+            size_t nl = s.find('\n', from + chunkSize);
+            if (nl != string::npos) to = nl + 1;
+        }
+        nextChunk = to;
+        const string &src = s;
+        pending.push_back(WorkPool::Shared().Submit([&src, from, to] { return lexChunk(src, from, to); }));
+    }
+
+public:
+    ParallelLexer(const string &src, size_t chunk = 1 << 20) : s(src), chunkSize(chunk) {
+        unsigned n = thread::hardware_concurrency();
+        if (n == 0) n = 1;
+        window = 2 * n;
+        WorkPool::Shared().Reserve(n);
+        while (pending.size() < window && nextChunk < s.size()) launch();
+    }
+
+    // chunks still being lexed read the source
+    ~ParallelLexer() {
+        for (future<Lexed> &f : pending) f.wait();
+    }
+
+    Token next() {
+        while (idx == cur.toks.size()) {
+            if (cur.stopped || pending.empty()) return {TokenType::END, "", base + cur.lines};
+            base += cur.lines;
+            cur = pending.front().get();
+            pending.pop_front();
+            idx = 0;
+            if (nextChunk < s.size()) launch();
+        }
+        Token t = cur.toks[idx++];
+        t.line += base;
+        return t;
+    }
 };
 
 int main(int argc, char **argv) {
@@ -354,7 +446,7 @@ int main(int argc, char **argv) {
         return 0;
     }
 
-    Lexer lex(src);
+    ParallelLexer lex(src);
     Token t;
     bool hadError = false;
 
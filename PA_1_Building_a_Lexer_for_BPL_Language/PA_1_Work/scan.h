@@ -0,0 +1,8 @@
+/*
+ * scan.h
+ * Bulk character-class scanning, from the BPL front end shared with prog2 and prog3
+ * Programming Assignment 1
+ * Fall 2025
+*/
+
+#include "../../BPL_Front_End/scan.h"
@@ -0,0 +1,81 @@
+/*
+ * checker.cpp
+ * Syntax checking of many BPL files at once
+ * Programming Assignment 2
+ * Fall 2025
+ */
+
+#include <algorithm>
+#include <filesystem>
+
+#include "checker.h"
+#include "lex.h"
+#include "parser.h"
+#include "workpool.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void CheckOne(FileReport& r, bool columns, bool tableParser)
+{
+	SourceBuffer source;
+	if( !source.OpenFile(r.path) )
+		return;
+	r.opened = true;
+
+	SourceCursor cursor(source);
+	SetTokenSource(&cursor);
+	if( columns )
+		SetLineTable(source.Lines());
+	if( tableParser )
+		SetParseEngine(ENGINE_LL1);
+	int line = 1;
+	vector<Diagnostic> errors;
+	CheckProg(source.Stream(), line, errors);
+	SetTokenSource(NULL);
+	SetLineTable(NULL);
+	SetParseEngine(ENGINE_RD);
+
+	//only the first message is ever shown
+	r.errors = int(errors.size());
+	if( !errors.empty() )
+		r.firstError = FormatError(errors.front(), columns ? source.Lines() : NULL);
+}
+
+} // namespace
+
+vector<string> ExpandPaths(const vector<string>& args)
+{
+	vector<string> paths;
+	for( const string& arg : args ) {
+		error_code ec;
+		if( !fs::is_directory(arg, ec) ) {
+			paths.push_back(arg);
+			continue;
+		}
+		//each directory's files sorted, so the order does not depend on the file system
+		size_t first = paths.size();
+		fs::recursive_directory_iterator it(arg, fs::directory_options::skip_permission_denied, ec), end;
+		for( ; !ec && it != end; it.increment(ec) )
+			if( it->is_regular_file(ec) )
+				paths.push_back(it->path().string());
+		sort(paths.begin() + first, paths.end());
+	}
+	return paths;
+}
+
+vector<FileReport> CheckFiles(const vector<string>& paths, unsigned threads, bool columns,
+	bool tableParser)
+{
+	vector<FileReport> reports(paths.size());
+	for( size_t i = 0; i < paths.size(); i++ )
+		reports[i].path = paths[i];
+
+	//each file is checked on whichever thread takes it next and writes only
+	//its own report
+	WorkPool::Shared().ForEach(reports.size(), threads, [&](size_t i) {
+		CheckOne(reports[i], columns, tableParser);
+	});
+	return reports;
+}
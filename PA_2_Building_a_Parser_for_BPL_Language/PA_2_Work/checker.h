@@ -0,0 +1,35 @@
+/*
+ * checker.h
+ * Syntax checking of many BPL files at once
+ * Programming Assignment 2
+ * Fall 2025
+*/
+
+#ifndef CHECKER_H_
+#define CHECKER_H_
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//Outcome of checking one file
+struct FileReport {
+	string	path;
+	bool	opened = false;
+	int	errors = 0;
+	string	firstError;	// as Prog would list it, "Line N: ..."
+};
+
+//The files to check: each argument, or every regular file under it when it
+//is a directory, in path order. Paths that do not exist are kept, so that
+//they get reported.
+extern vector<string> ExpandPaths(const vector<string>& args);
+
+//Parses each file on its own, on a pool of threads workers, with the LL(1)
+//table engine when tableParser is set. The reports are in the order of
+//paths, whatever order the files finish in.
+extern vector<FileReport> CheckFiles(const vector<string>& paths, unsigned threads, bool columns,
+	bool tableParser = false);
+
+#endif /* CHECKER_H_ */
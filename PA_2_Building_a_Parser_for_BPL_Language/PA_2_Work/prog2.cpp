@@ -6,50 +6,277 @@
  */
 #include <iostream>
 #include <fstream>
+#include <thread>
+#include <cstdlib>
+#include <cstdio>
 
 #include "lex.h"
 #include "parser.h"
+#include "tokcache.h"
+#include "ast.h"
+#include "checker.h"
+#include "reparse.h"
 
 
 using namespace std;
 
 
+//prog2 -check [-col] [-ll1] [-jobs N] path...: one line per file, in
+//argument order, then the totals. Exits with 1 if any file fails or cannot
+//be read.
+static int CheckMode(int argc, char *argv[])
+{
+	bool columns = false;
+	bool tableParser = false;
+	unsigned jobs = thread::hardware_concurrency();
+	vector<string> names;
+
+	for( int i=1; i<argc; i++ )
+	{
+		string arg = argv[i];
+
+		if( arg == "-check" )
+			continue;
+		else if( arg == "-col" )
+			columns = true;
+		else if( arg == "-ll1" )
+			tableParser = true;
+		else if( arg == "-jobs" )
+		{
+			if( i + 1 >= argc || atoi(argv[i + 1]) <= 0 )
+			{
+				cerr << "MISSING OR BAD JOB COUNT" << endl;
+				return 0;
+			}
+			jobs = atoi(argv[++i]);
+		}
+		else
+			names.push_back(arg);
+	}
+	if( names.empty() )
+	{
+		cerr << "Missing File Name." << endl;
+		return 0;
+	}
+
+	vector<FileReport> reports = CheckFiles(ExpandPaths(names), jobs, columns, tableParser);
+	size_t passed = 0, failed = 0, unread = 0, errors = 0;
+	for( const FileReport& r : reports )
+	{
+		cout << r.path << ": ";
+		if( !r.opened )
+		{
+			cout << "CANNOT OPEN" << endl;
+			unread++;
+		}
+		else if( r.errors == 0 )
+		{
+			cout << "Successful Parsing" << endl;
+			passed++;
+		}
+		else
+		{
+			cout << "Unsuccessful Parsing, " << r.errors << " Syntax Errors, first: " << r.firstError << endl;
+			failed++;
+			errors += r.errors;
+		}
+	}
+	cout << "Files " << reports.size() << ", Successful " << passed << ", Unsuccessful " << failed
+		<< ", Unreadable " << unread << ", Syntax Errors " << errors << endl;
+	return failed || unread ? 1 : 0;
+}
+
+static void PrintDiagnostics(const Reparser& doc)
+{
+	vector<Diagnostic> errors;
+	if( doc.Diagnostics(errors) )
+	{
+		cout << "Successful Parsing" << endl;
+		return;
+	}
+	for( size_t i = 0; i < errors.size(); i++ )
+		cout << (i + 1) << ". " << doc.Message(errors[i]) << endl;
+	cout << "Unsuccessful Parsing" << endl << "Number of Syntax Errors " << errors.size() << endl;
+}
+
+//prog2 -edit [-col] FILE: reads edits from stdin, one per line as
+//"OFFSET LENGTH TEXT", with \n, \t and \\ escapes in TEXT, and reports the
+//diagnostics after opening the file and after each edit
+static int EditMode(int argc, char *argv[])
+{
+	bool columns = false;
+	string name;
+	for( int i=1; i<argc; i++ )
+	{
+		string arg = argv[i];
+		if( arg == "-col" )
+			columns = true;
+		else if( arg != "-edit" )
+			name = arg;
+	}
+
+	SourceBuffer source;
+	if( name.empty() || !source.OpenFile(name) )
+	{
+		cerr << "CANNOT OPEN " << name << endl;
+		return 0;
+	}
+	Reparser doc(columns);
+	doc.Open(string(source.Begin(), source.Size()));
+	PrintDiagnostics(doc);
+
+	string line;
+	while( getline(cin, line) )
+	{
+		size_t offset, length;
+		int used = 0;
+		if( sscanf(line.c_str(), "%zu %zu%n", &offset, &length, &used) < 2 )
+		{
+			cerr << "BAD EDIT " << line << endl;
+			continue;
+		}
+		string text;
+		for( size_t i = used + 1; i < line.size(); i++ )
+		{
+			if( line[i] == '\\' && i + 1 < line.size() )
+			{
+				char c = line[++i];
+				text += c == 'n' ? '\n' : c == 't' ? '\t' : c;
+			}
+			else
+				text += line[i];
+		}
+		doc.Edit(offset, length, text);
+		PrintDiagnostics(doc);
+	}
+	return 0;
+}
 
 int main(int argc, char *argv[])
 {
 	int lineNumber = 1;
 
+	for( int i=1; i<argc; i++ )
+	{
+		if( string(argv[i]) == "-check" )
+			return CheckMode(argc, argv);
+		if( string(argv[i]) == "-edit" )
+			return EditMode(argc, argv);
+	}
+
 	istream *in = NULL;
-	ifstream file;
+	SourceBuffer source;
+	BlockReader stdinReader(0);
+	bool columns = false;
+	string tokCache;
+	string astFile;
+	bool parallelParse = false;
+	bool tableParser = false;
 		
 	for( int i=1; i<argc; i++ )
     {
 		string arg = argv[i];
 		
-		if( in != NULL ) 
+		if( arg == "-col" )
+		{
+			columns = true;
+		}
+		else if( arg == "-pparse" )
+		{
+			parallelParse = true;
+		}
+		else if( arg == "-ll1" )
+		{
+			tableParser = true;
+		}
+		else if( arg == "-tokcache" )
+		{
+			if( i + 1 >= argc )
+			{
+				cerr << "MISSING TOKEN CACHE FILE NAME" << endl;
+				return 0;
+			}
+			tokCache = argv[++i];
+		}
+		else if( arg == "-ast" )
+		{
+			if( i + 1 >= argc )
+			{
+				cerr << "MISSING AST FILE NAME" << endl;
+				return 0;
+			}
+			astFile = argv[++i];
+		}
+		else if( in != NULL ) 
         {
 			cerr << "ONLY ONE FILE NAME ALLOWED" << endl;
 			return 0;
 		}
+		else if( arg == "-" )
+		{
+			in = &cin;
+		}
 		else 
         {
-			file.open(arg.c_str());
-			if( file.is_open() == false ) 
+			if( source.OpenFile(arg) == false ) 
             {
 				cerr << "CANNOT OPEN " << arg << endl;
 				return 0;
 			}
 
-			in = &file;
+			in = &source.Stream();
 		}
 	}
-	if(argc == 1)
+	if(in == NULL)
 	{
 		cerr << "Missing File Name." << endl;
 		return 0;
 	}
     
+    //the token cache and the tree refer to the whole program in memory
+    if( in == &cin && (!tokCache.empty() || !astFile.empty()) )
+    {
+        source.ReadStream(cin);
+        in = &source.Stream();
+    }
+
+    //tokens saved by an earlier prog2 or prog3 run over the same source
+    TokenCache cache(source);
+    bool cached = false;
+    if( !tokCache.empty() )
+    {
+        cached = cache.Load(tokCache);
+        if( !cached && (cached = cache.Build()) && !cache.Save(tokCache) )
+            cerr << "CANNOT WRITE TOKEN CACHE " << tokCache << endl;
+    }
+
+    SourceCursor cursor(source);
+    if( cached )
+        SetTokenCache(&cache);
+    else if( in == &cin )
+        SetTokenReader(&stdinReader);
+    else
+        SetTokenSource(&cursor);
+    if( columns && in != &cin )
+        SetLineTable(source.Lines());
+    Ast ast;
+    if( !astFile.empty() )
+        SetAstOutput(&ast);
+    if( parallelParse )
+        SetParseThreads(thread::hardware_concurrency());
+    if( tableParser )
+        SetParseEngine(ENGINE_LL1);
     bool status = Prog(*in, lineNumber);
+    SetTokenSource(NULL);
+    SetTokenReader(NULL);
+    SetTokenCache(NULL);
+    SetLineTable(NULL);
+    SetAstOutput(NULL);
+    SetParseThreads(1);
+    SetParseEngine(ENGINE_RD);
+
+    if( status && !astFile.empty() && !ast.Save(astFile, source, DIALECT_PROG2) )
+        cerr << "CANNOT WRITE AST FILE " << astFile << endl;
     
     if( !status )
     {
@@ -0,0 +1,214 @@
+/*
+ * reparse.cpp
+ * Incremental reparsing of a BPL program as it is edited
+ * Programming Assignment 2
+ * Fall 2025
+ */
+
+#include <algorithm>
+
+#include "reparse.h"
+
+namespace {
+const uint32_t NoSegment = ~0u;
+}
+
+SourceCursor Reparser::Whole() const
+{
+	return SourceCursor(text.data(), text.data() + text.size(), &lines);
+}
+
+uint32_t Reparser::Intern(const string& name)
+{
+	return ids.emplace(name, uint32_t(ids.size())).first->second;
+}
+
+void Reparser::Parse(Segment& seg, size_t b, size_t e)
+{
+	SourceCursor whole = Whole();
+	ParseStmtRun(whole, whole.beg + b, whole.beg + e, b == 0, seg.run);
+
+	seg.declared.clear();
+	for( const string& v : seg.run.declared )
+		seg.declared.push_back(Intern(v));
+	seg.undefined.clear();
+	for( size_t u : seg.run.undefined )
+		seg.undefined.push_back(Intern(seg.run.errors[u].name));
+}
+
+void Reparser::Parse(size_t i)
+{
+	Parse(segs[i], starts[i], End(i));
+	segs[i].at = starts[i];
+	segs[i].line = lines.Line(starts[i]);
+	const StmtRun& run = segs[i].run;
+	marks[i] = (run.failed || !run.reachedEnd ? Stops : 0) | (run.errors.empty() ? 0 : HasErrors);
+}
+
+size_t Reparser::Reparse(size_t from, size_t to, size_t b, size_t e)
+{
+	//e must still end a statement, else a token now runs past it: take in
+	//the statements after it until one does
+	vector<const char*> cuts;
+	for( ;; ) {
+		if( e == text.size() ) {
+			cuts = StatementCuts(text.data() + b, text.data() + e, 1);
+			break;
+		}
+		cuts = StatementCuts(text.data() + b, text.data() + e + 1, 1);
+		if( cuts[cuts.size() - 2] == text.data() + e ) {
+			cuts.pop_back();
+			break;
+		}
+		e = End(to++);
+	}
+
+	//the cached first declarations survive if these statements declared
+	//none first and declare the same variables as before
+	size_t count = cuts.size() - 1;
+	vector<uint32_t> before, after;
+	for( size_t i = from; i < to; i++ )
+		before.insert(before.end(), segs[i].declared.begin(), segs[i].declared.end());
+
+	//reuse the slots the old statements held, then open or close the gap
+	if( count > to - from ) {
+		size_t more = count - (to - from);
+		starts.insert(starts.begin() + to, more, 0);
+		marks.insert(marks.begin() + to, more, 0);
+		segs.insert(segs.begin() + to, more, Segment());
+	}
+	else {
+		starts.erase(starts.begin() + from + count, starts.begin() + to);
+		marks.erase(marks.begin() + from + count, marks.begin() + to);
+		segs.erase(segs.begin() + from + count, segs.begin() + to);
+	}
+	for( size_t k = 0; k < count; k++ )
+		starts[from + k] = cuts[k] - text.data();
+	for( size_t k = 0; k < count; k++ ) {
+		Parse(from + k);
+		after.insert(after.end(), segs[from + k].declared.begin(), segs[from + k].declared.end());
+	}
+
+	if( firstDeclValid ) {
+		sort(before.begin(), before.end());
+		before.erase(unique(before.begin(), before.end()), before.end());
+		sort(after.begin(), after.end());
+		after.erase(unique(after.begin(), after.end()), after.end());
+		firstDeclValid = before == after;
+		long moved = long(count) - long(to - from);
+		for( size_t v = 0; firstDeclValid && v < firstDecl.size(); v++ ) {
+			if( firstDecl[v] == NoSegment || firstDecl[v] < from )
+				continue;
+			if( firstDecl[v] < to )
+				firstDeclValid = false;
+			else
+				firstDecl[v] += moved;
+		}
+	}
+	return e;
+}
+
+string Reparser::Message(const Diagnostic& d) const
+{
+	return FormatError(d, columns ? &lines : NULL);
+}
+
+void Reparser::Open(const string& source)
+{
+	text = source;
+	lines.Build(text.data(), text.data() + text.size());
+	starts.clear();
+	marks.clear();
+	segs.clear();
+	ids.clear();
+	firstDeclValid = false;
+	Reparse(0, 0, 0, text.size());
+}
+
+void Reparser::Edit(size_t offset, size_t removed, const string& inserted)
+{
+	offset = min(offset, text.size());
+	removed = min(removed, text.size() - offset);
+	long shift = long(inserted.size()) - long(removed);
+
+	//the statements holding the first and the last byte touched; an edit
+	//right after a ';' belongs to the statement that follows
+	auto after = [&](size_t at) { return size_t(upper_bound(starts.begin(), starts.end(), at) - starts.begin()); };
+	size_t from = max<size_t>(after(offset), 1) - 1;
+	size_t to = max(after(offset + removed), from + 1);
+	size_t b = starts[from];
+	size_t e = End(to - 1) + shift;
+
+	text.replace(offset, removed, inserted);
+	lines.Replace(text.data(), text.data() + text.size(), offset, removed, inserted.size());
+	for( size_t i = to; i < starts.size(); i++ )
+		starts[i] += shift;
+	Reparse(from, to, b, e);
+}
+
+void Reparser::FirstDeclarations() const
+{
+	firstDecl.assign(ids.size(), NoSegment);
+	for( size_t i = segs.size(); i-- > 0; )
+		for( uint32_t v : segs[i].declared )
+			firstDecl[v] = uint32_t(i);
+	firstDeclValid = true;
+}
+
+void Reparser::Report(size_t i, StmtRun& out) const
+{
+	//the statement's text is as parsed, though edits above may have moved it
+	const Segment& seg = segs[i];
+	int lineShift = 0;
+	bool shiftKnown = false;
+	size_t u = 0;
+	for( size_t j = 0; j < seg.run.errors.size(); j++ ) {
+		if( u < seg.run.undefined.size() && seg.run.undefined[u] == j )
+			if( firstDecl[seg.undefined[u++]] < i )
+				continue;
+		if( !shiftKnown ) {
+			lineShift = lines.Line(starts[i]) - seg.line;
+			shiftKnown = true;
+		}
+		out.errors.push_back(seg.run.errors[j]);
+		Diagnostic& d = out.errors.back();
+		d.line += lineShift;
+		if( d.offset != TokenView::NoOffset )
+			d.offset += unsigned(starts[i] - seg.at);
+	}
+}
+
+bool Reparser::Diagnostics(vector<Diagnostic>& errors) const
+{
+	errors.clear();
+
+	//runs stand as parsed up to the first one that ends the program
+	size_t k = find_if(marks.begin(), marks.end(), [](uint8_t m) { return m & Stops; }) - marks.begin();
+	size_t last = min(k + 1, segs.size());
+	if( !firstDeclValid )
+		FirstDeclarations();
+	firstDecl.resize(ids.size(), NoSegment);
+
+	StmtRun prior;
+	for( size_t i = 0; i < last; i++ ) {
+		if( !(marks[i] & HasErrors) )
+			continue;
+		if( i == k && segs[i].run.failed )
+			break;
+		Report(i, prior);
+	}
+
+	if( k == segs.size() || !segs[k].run.failed ) {
+		errors = move(prior.errors);
+		return errors.empty();
+	}
+
+	//a syntax error: parse on from that statement, as Prog would get there
+	function<bool(string_view)> declared = [&](string_view v) {
+		auto it = ids.find(string(v));
+		return it != ids.end() && firstDecl[it->second] < k;
+	};
+	SourceCursor whole = Whole();
+	prior.lastTokAt = unsigned(starts[k]);
+	return ResumeProg(whole, whole.beg + starts[k], k == 0, prior, declared, errors);
+}
@@ -0,0 +1,83 @@
+/*
+ * reparse.h
+ * Incremental reparsing of a BPL program as it is edited
+ * Programming Assignment 2
+ * Fall 2025
+*/
+
+#ifndef REPARSE_H_
+#define REPARSE_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+using namespace std;
+
+#include "lex.h"
+#include "parser.h"
+
+//An open document, kept as one run per top-level statement (an if with
+//its blocks is one statement), each with the result of parsing it on its
+//own. An edit re-lexes and reparses only the statements it touches;
+//Diagnostics stitches the runs back into what Prog reports for the whole
+//text. Past a statement with a syntax error it parses in order, as Prog
+//would, until it stops.
+class Reparser {
+	struct Segment {
+		StmtRun	run;
+		vector<uint32_t>	declared;	// run.declared, interned
+		vector<uint32_t>	undefined;	// variables of run.undefined, interned
+		//where the statement started when parsed; the lines and offsets
+		//of its messages move with it
+		size_t	at;
+		int	line;
+	};
+	enum : uint8_t { Stops = 1, HasErrors = 2 };
+
+	string	text;
+	LineTable	lines;
+	//one entry per statement in each; the first two are kept apart so
+	//that edits and Diagnostics scan a few bytes per statement
+	vector<size_t>	starts;	// a statement ends where the next one starts
+	vector<uint8_t>	marks;
+	vector<Segment>	segs;
+	unordered_map<string, uint32_t>	ids;
+	//the first statement to declare each variable, kept across edits
+	//that leave the declarations alone
+	mutable vector<uint32_t>	firstDecl;
+	mutable bool	firstDeclValid;
+	bool	columns;
+
+	SourceCursor	Whole() const;
+	size_t	End(size_t i) const { return i + 1 < starts.size() ? starts[i + 1] : text.size(); }
+	uint32_t	Intern(const string& name);
+	void	Parse(size_t i);
+	void	Parse(Segment& seg, size_t b, size_t e);
+	//replaces statements [from, to) with those of text[b, e), taking in
+	//more if e no longer ends one; returns where they end
+	size_t	Reparse(size_t from, size_t to, size_t b, size_t e);
+	void	FirstDeclarations() const;
+	//appends the messages of statement i that Prog would give
+	void	Report(size_t i, StmtRun& out) const;
+
+public:
+	//columns: error messages give columns, as prog2 -col does
+	explicit Reparser(bool columns = false) : firstDeclValid(false), columns(columns) {}
+
+	void	Open(const string& source);
+	//Replaces removed bytes at offset with inserted
+	void	Edit(size_t offset, size_t removed, const string& inserted);
+
+	const string&	Text() const { return text; }
+	size_t	Statements() const { return segs.size(); }
+
+	//Prog's verdict on the text as it is now; errors gets the messages it
+	//would list
+	bool	Diagnostics(vector<Diagnostic>& errors) const;
+	//The message prog2 prints for an error of Diagnostics
+	string	Message(const Diagnostic& d) const;
+};
+
+#endif /* REPARSE_H_ */
@@ -0,0 +1,439 @@
+/*
+ * bench3.cpp
+ * Benchmark driver for the BPL lexer and interpreter
+ * Programming Assignment 3
+ * Fall 2025
+ *
+ * Build with make in this directory, which links every PA_3_Work source
+ * except prog3.cpp and the front end library.
+ *
+ * Usage:
+ *   bench3 [-reps N] [-scale F] [-only NAME] [-baseline FILE] [-threshold PCT]
+ *   bench3 -emit NAME SIZE
+ *   bench3 -alloccheck
+ *
+ * Results are printed as CSV, one row per workload and phase. The lex phase
+ * only tokenizes, with the table-driven lexer, which keeps no line; lexold
+ * does the same with the hand-written one, which counts newlines, after
+ * checking that both produce the same tokens and that the lines the parser
+ * would look up for them are the ones counted. lexpush feeds the source to a PushLexer in 4 KiB pieces,
+ * as a server reading a socket would, after checking it gets the same tokens.
+ * The tree phase runs the program the way prog3 does: parsed to a syntax
+ * tree by the front end shared with prog2, then run from the tree, so parse
+ * time is included there; treell1 is the same with the tree built by the
+ * front end's LL(1) table engine. Passing the saved output of an earlier
+ * run with -baseline appends the time ratio to every row and flags rows that got slower than the threshold (default 5%);
+ * the exit status is 1 if any row regressed.
+ *
+ * -alloccheck runs a loop of numeric and Boolean statements from its tree,
+ * built by each engine, once to warm up and once more counting allocations,
+ * and exits with status 1 unless the second run made none.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <queue>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "lex.h"
+#include "parser.h"
+#include "treeexec.h"
+
+using namespace std;
+
+// ---- allocation counting ----
+
+static unsigned long long gAllocCount = 0;
+static unsigned long long gAllocBytes = 0;
+
+void* operator new(size_t n) {
+    gAllocCount++;
+    gAllocBytes += n;
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+
+// Kept out of line, so the compiler never pairs a free it inlined with a new
+// it did not
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ---- workloads ----
+
+struct Workload {
+    const char* name;
+    int size;                       // default size parameter
+    string (*make)(int size);
+};
+
+// x = ((((1 + 2) * 3) + 4) ...);  nested SIZE levels deep
+static string MakeNest(int size) {
+    ostringstream os;
+    for (int rep = 0; rep < 20; rep++) {
+        os << "x = ";
+        for (int i = 0; i < size; i++) os << "(";
+        os << "1";
+        for (int i = 0; i < size; i++) os << (i % 2 ? " * 1" : " + 2") << ")";
+        os << ";\n";
+    }
+    os << "println(x);\n";
+    return os.str();
+}
+
+// long '.' chains followed by '.=' appends
+static string MakeCatChain(int size) {
+    ostringstream os;
+    os << "s = \"a\"";
+    for (int i = 0; i < size; i++) os << " . \"b" << i % 10 << "\"";
+    os << ";\n";
+    for (int i = 0; i < size; i++) os << "s .= 'c';\n";
+    os << "println(s);\n";
+    return os.str();
+}
+
+// '.x.' repetition of short and long strings
+static string MakeRepeat(int size) {
+    ostringstream os;
+    os << "base = \"abc\";\n";
+    for (int i = 0; i < size; i++)
+        os << "r" << i % 16 << " = base .x. " << (i % 64) << ";\n";
+    os << "big = base .x. " << size * 10 << ";\n";
+    os << "println(r3, big @eq r3);\n";
+    return os.str();
+}
+
+// SIZE distinct variables, each defined and then read
+static string MakeVars(int size) {
+    ostringstream os;
+    for (int i = 0; i < size; i++) os << "v" << i << " = " << i << ";\n";
+    for (int i = 1; i < size; i++) os << "v" << i << " = v" << i << " + v" << i - 1 << ";\n";
+    os << "println(v" << size - 1 << ");\n";
+    return os.str();
+}
+
+// a large if block whose condition is false, so it is only skipped
+static string MakeUntaken(int size) {
+    ostringstream os;
+    os << "c = 0;\n";
+    for (int blk = 0; blk < 10; blk++) {
+        os << "if (c) {\n";
+        for (int i = 0; i < size; i++)
+            os << "  y = (c + " << i << ") * 2 . \"s\";\n  println(y, \" \", c);\n";
+        os << "} else {\n  c = c + 0;\n};\n";
+    }
+    os << "println(c);\n";
+    return os.str();
+}
+
+// strings that hold numbers mixed into arithmetic and catenation
+static string MakeMixed(int size) {
+    ostringstream os;
+    os << "a = \"12\";\nn = 3;\n";
+    for (int i = 0; i < size; i++) {
+        os << "b = a * n + " << i % 7 << ";\n";
+        os << "t = b . \"\" . n;\n";
+        os << "n = (t % 97) + 1;\n";
+    }
+    os << "println(t, \" \", n);\n";
+    return os.str();
+}
+
+static const Workload workloads[] = {
+    { "nest",     200,  MakeNest },
+    { "catchain", 2000, MakeCatChain },
+    { "repeat",   2000, MakeRepeat },
+    { "vars",     3000, MakeVars },
+    { "untaken",  1000, MakeUntaken },
+    { "mixed",    2000, MakeMixed },
+};
+
+// ---- phases ----
+
+class NullBuf : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+struct PhaseResult {
+    vector<long long> ns;
+    unsigned long long ops = 0;
+    unsigned long long allocs = 0;
+    unsigned long long allocBytes = 0;
+    bool ok = true;
+};
+
+// next is any callable TokenView(SourceCursor&)
+template <class Next>
+static unsigned long long RunLex(const string& src, Next next) {
+    SourceCursor in(src.data(), src.data() + src.size());
+    unsigned long long n = 0;
+    while (true) {
+        TokenView t = next(in);
+        n++;
+        if (t.kind == DONE || t.kind == ERR) break;
+    }
+    return n;
+}
+
+// Feeds the source to a PushLexer in pieces; calls each(token) per token
+template <class Each>
+static void PushLex(const string& src, size_t piece, Each each) {
+    PushLexer lexer(1);
+    LexItem t;
+    for (size_t i = 0; i < src.size(); i += piece) {
+        lexer.Feed(src.data() + i, min(piece, src.size() - i));
+        while (lexer.Next(t)) each(t);
+    }
+    lexer.Finish();
+    while (lexer.Next(t)) each(t);
+}
+
+// The lines of the tokens of one pass over src, in order, looked up the way
+// the parser looks them up
+class LineLookup {
+    LineTable table;
+    const char* text;
+    size_t hint = 0;
+    int swallowed = 0;
+
+public:
+    explicit LineLookup(const string& src) : text(src.data()) {
+        table.Build(src.data(), src.data() + src.size());
+    }
+    int operator()(const TokenView& t) {
+        int line = table.Line(t.offset, hint) - swallowed;
+        swallowed += t.SwallowsNewline(text);
+        return line;
+    }
+};
+
+// True if a PushLexer fed in pieces gives what getNextToken gives at once
+static bool PushLexerAgrees(const string& src, size_t piece) {
+    SourceCursor whole(src.data(), src.data() + src.size());
+    LineLookup lineOf(src);
+    bool same = true;
+    PushLex(src, piece, [&](const LexItem& x) {
+        TokenView y = getNextToken(whole);
+        same = same && x.GetToken() == y.kind && x.GetLexemeView() == y.Lexeme(whole.beg)
+            && x.GetLinenum() == lineOf(y) && x.GetOffset() == y.offset;
+    });
+    return same && whole.cur == whole.end;
+}
+
+// 1-based index of the first token where the two lexers disagree, or 0. The
+// hand-written lexer counts lines, which the looked-up ones must match.
+static unsigned long long LexerMismatch(const string& src) {
+    SourceCursor a(src.data(), src.data() + src.size());
+    SourceCursor b(src.data(), src.data() + src.size());
+    LineLookup lineOf(src);
+    int lb = 1;
+    for (unsigned long long n = 1; ; n++) {
+        TokenView x = getNextToken(a);
+        TokenView y = getNextTokenLegacy(b, lb);
+        if (x.kind != y.kind || x.offset != y.offset || x.length != y.length || lineOf(x) != lb || a.cur != b.cur)
+            return n;
+        if (x.kind == DONE) return 0;
+    }
+}
+
+static bool RunTree(const SourceBuffer& src, bool tableParser) {
+    NullBuf sink;
+    streambuf* saved = cout.rdbuf(&sink);
+    int line = 1;
+    SetParseEngine(tableParser ? ENGINE_LL1 : ENGINE_RD);
+    bool ok = ProgFromTree(src, line);
+    SetParseEngine(ENGINE_RD);
+    cout.rdbuf(saved);
+    return ok;
+}
+
+// y = 2; then statements that only compute numbers and test them
+static string MakeNumericLoop(int size) {
+    ostringstream os;
+    os << "y = 2;\nx = 0;\n";
+    for (int i = 0; i < size; i++) {
+        os << "x = y + 1;\n";
+        os << "y += x * 3 - y / 2;\n";
+        os << "if (x < y && !(y == 0) || x >= 7) {\n  y -= x % 5;\n} else {\n  x = -x ** 2;\n};\n";
+    }
+    return os.str();
+}
+
+// Runs src from a tree the engine builds twice, counting the allocations of
+// the second run; false if it made any or the program failed
+static bool RunsWithoutAllocating(const SourceBuffer& src, bool tableParser, unsigned long long& allocs) {
+    Ast ast;
+    vector<Diagnostic> errors;
+    int line = 1;
+    SetParseEngine(tableParser ? ENGINE_LL1 : ENGINE_RD);
+    bool ok = ParseProg(src, line, ast, errors);
+    SetParseEngine(ENGINE_RD);
+    if (!ok) return false;
+
+    TreeRun run(ast, src);
+    if (!run.Block(ast.Root())) return false;
+    unsigned long long before = gAllocCount;
+    ok = run.Block(ast.Root());
+    allocs = gAllocCount - before;
+    return ok && allocs == 0;
+}
+
+template <class F>
+static void Measure(PhaseResult& r, int reps, F body) {
+    for (int i = 0; i < reps; i++) {
+        unsigned long long a0 = gAllocCount, b0 = gAllocBytes;
+        auto t0 = chrono::steady_clock::now();
+        body();
+        auto t1 = chrono::steady_clock::now();
+        r.ns.push_back(chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count());
+        r.allocs = gAllocCount - a0;
+        r.allocBytes = gAllocBytes - b0;
+    }
+    sort(r.ns.begin(), r.ns.end());
+}
+
+// ---- baseline comparison ----
+
+typedef map<string, long long> Baseline;   // "workload,size,phase" -> median ns
+
+static bool LoadBaseline(const string& file, Baseline& base) {
+    ifstream in(file);
+    if (!in.is_open()) return false;
+    string row;
+    getline(in, row);   // header
+    while (getline(in, row)) {
+        vector<string> f;
+        stringstream ss(row);
+        string cell;
+        while (getline(ss, cell, ',')) f.push_back(cell);
+        if (f.size() < 5) continue;
+        base[f[0] + "," + f[1] + "," + f[2]] = atoll(f[4].c_str());
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    int reps = 5;
+    double scale = 1.0;
+    double threshold = 5.0;
+    string only, baselineFile;
+    bool allocCheck = false;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasNext = i + 1 < argc;
+        if (arg == "-reps" && hasNext) reps = max(1, atoi(argv[++i]));
+        else if (arg == "-scale" && hasNext) scale = atof(argv[++i]);
+        else if (arg == "-only" && hasNext) only = argv[++i];
+        else if (arg == "-baseline" && hasNext) baselineFile = argv[++i];
+        else if (arg == "-threshold" && hasNext) threshold = atof(argv[++i]);
+        else if (arg == "-alloccheck") allocCheck = true;
+        else if (arg == "-emit" && i + 2 < argc) {
+            string name = argv[i + 1];
+            for (const Workload& w : workloads)
+                if (name == w.name) { cout << w.make(atoi(argv[i + 2])); return 0; }
+            cerr << "UNKNOWN WORKLOAD {" << name << "}" << endl;
+            return 2;
+        }
+        else {
+            cerr << "UNRECOGNIZED FLAG {" << arg << "}" << endl;
+            return 2;
+        }
+    }
+
+    if (allocCheck) {
+        SourceBuffer text;
+        text.SetText(MakeNumericLoop(max(1, (int)(1000 * scale))));
+        bool clean = true;
+        for (bool tableParser : { false, true }) {
+            unsigned long long allocs = 0;
+            bool ok = RunsWithoutAllocating(text, tableParser, allocs);
+            cout << (tableParser ? "treell1" : "tree") << ": " << allocs << " allocations"
+                 << (ok ? "" : ", FAILED") << endl;
+            clean = clean && ok;
+        }
+        return clean ? 0 : 1;
+    }
+
+    Baseline base;
+    if (!baselineFile.empty() && !LoadBaseline(baselineFile, base)) {
+        cerr << "CANNOT OPEN " << baselineFile << endl;
+        return 2;
+    }
+
+    cout << "workload,size,phase,reps,median_ns,min_ns,ops,ops_per_sec,allocs,alloc_bytes";
+    if (!base.empty()) cout << ",baseline_ns,ratio,status";
+    cout << endl;
+
+    bool regressed = false;
+    for (const Workload& w : workloads) {
+        if (!only.empty() && only != w.name) continue;
+
+        int size = max(1, (int)(w.size * scale));
+        string src = w.make(size);
+
+        if (unsigned long long bad = LexerMismatch(src))
+            cerr << w.name << ": lexers disagree at token " << bad << endl;
+        if (!PushLexerAgrees(src, 4096))
+            cerr << w.name << ": push lexer disagrees" << endl;
+
+        SourceBuffer text;
+        text.SetText(src);
+
+        PhaseResult lex, lexold, lexpush, tree, treell1;
+        Measure(lex, reps, [&] {
+            lex.ops = RunLex(src, [](SourceCursor& in) { return getNextToken(in); });
+        });
+        Measure(lexold, reps, [&] {
+            int line = 1;
+            lexold.ops = RunLex(src, [&](SourceCursor& in) { return getNextTokenLegacy(in, line); });
+        });
+        Measure(lexpush, reps, [&] {
+            lexpush.ops = 0;
+            PushLex(src, 4096, [&](const LexItem&) { lexpush.ops++; });
+        });
+        Measure(tree, reps, [&] { tree.ok = RunTree(text, false) && tree.ok; });
+        tree.ops = lex.ops;
+        Measure(treell1, reps, [&] { treell1.ok = RunTree(text, true) && treell1.ok; });
+        treell1.ops = lex.ops;
+
+        const pair<const char*, PhaseResult*> phases[] = {
+            { "lex", &lex }, { "lexold", &lexold }, { "lexpush", &lexpush }, { "tree", &tree },
+            { "treell1", &treell1 }
+        };
+        for (const auto& ph : phases) {
+            const PhaseResult& r = *ph.second;
+            long long med = r.ns[r.ns.size() / 2];
+            double opsPerSec = med ? r.ops * 1e9 / med : 0.0;
+            string key = string(w.name) + "," + to_string(size) + "," + ph.first;
+
+            cout << key << "," << reps << "," << med << "," << r.ns.front() << ","
+                 << r.ops << "," << (long long)opsPerSec << ","
+                 << r.allocs << "," << r.allocBytes;
+            if (!base.empty()) {
+                auto b = base.find(key);
+                if (b == base.end() || b->second == 0) {
+                    cout << ",,,new";
+                }
+                else {
+                    double ratio = (double)med / b->second;
+                    bool slow = ratio > 1.0 + threshold / 100.0;
+                    regressed = regressed || slow;
+                    cout << "," << b->second << "," << ratio << ","
+                         << (slow ? "REGRESSION" : (ratio < 1.0 - threshold / 100.0 ? "faster" : "same"));
+                }
+            }
+            cout << endl;
+            if (!r.ok) cerr << w.name << ": program reported errors" << endl;
+        }
+    }
+    return regressed ? 1 : 0;
+}
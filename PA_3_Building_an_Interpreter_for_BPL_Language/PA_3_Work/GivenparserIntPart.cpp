@@ -7,48 +7,104 @@
 
 
 #include "parserInt.h"
+#include "treeexec.h"
+#include "tokpipe.h"
+#include "rulestats.h"
 
-map<string, bool> defVar;
+map<string, bool, less<>> defVar;
 map<string, Token> SymTable;
-map<string, Value> TempsResults; //Container of temporary locations of Value objects for results of expressions, variables values and constants 
-queue <Value> * ValQue; //declare a pointer variable to a queue of Value objects
+map<string, Value, less<>> TempsResults; //Container of temporary locations of Value objects for results of expressions, variables values and constants
+vector<Value> ValQue; //values of the PrintLn being run, cleared but not freed between statements
 
 namespace Parser {
 
+    TokenPipe* tokenPipe = nullptr; //set when the lexer runs on its own thread
+    SourceCursor* source = nullptr; //set when the program is lexed from memory
+    BlockReader* reader = nullptr;  //set when the program is read from a pipe
+    unsigned lastOffset = LexItem::NoOffset; //of the last token handed out
+
     bool pushed_back = false;
     LexItem pushed_token;
-// for the other code dont forget to remove static
-     LexItem GetNextToken(istream& in, int& line) {
-        if (pushed_back) {
-            pushed_back = false;
-            return pushed_token;
+
+    static LexItem NextToken(istream& in, int& line) {
+        if (tokenPipe)
+            return tokenPipe->Pop(line);
+        if (source) {
+            TokenView t = getNextTokenLegacy(*source, line);
+            string_view lexeme = t.Lexeme(source->beg);
+            return LexItem(t.kind, string(lexeme), line, t.offset);
         }
+        if (reader)
+            return getNextToken(*reader, line);
         return getNextToken(in, line);
     }
-//same here
-    void PushBackToken(LexItem &t) {
+    //line is left as the lexer left it after the token, even when the
+    //token was pushed back and is read again
+    const LexItem& GetNextToken(istream& in, int& line) {
+        RULE_TOKEN();
+        if (pushed_back)
+            pushed_back = false;
+        else
+            pushed_token = NextToken(in, line);
+        lastOffset = pushed_token.GetOffset();
+        return pushed_token;
+    }
+    //a peeked token counts as read for the line and column of an error
+    const LexItem& PeekToken(istream& in, int& line) {
+        const LexItem& t = GetNextToken(in, line);
+        pushed_back = true;
+        return t;
+    }
+    void PushBackToken(const LexItem& t) {
+        RULE_PUSHBACK();
         if (pushed_back) {
             cerr << "PushBackToken(): double push" << endl;
             exit(1);
         }
         pushed_back = true;
-        pushed_token = t;
+        if (&t != &pushed_token)
+            pushed_token = t;
     }
 }
 
 
-static int error_count = 0;
-
 int ErrCount()
 {
-    return error_count;
+    return ErrorsReported();
 }
 
 void ParseError(int line, string msg)
 {
-	++error_count;
-	cout << error_count << ". Line " << line << ": " << msg << endl;
+	ReportError(line, Parser::lastOffset, msg);
 }
 
+bool ProgFromSource(const SourceBuffer& src, int& line)
+{
+	SourceCursor cursor(src);
+	istream none(nullptr);
+	Parser::source = &cursor;
+	bool ok = ::Prog(none, line);
+	Parser::source = nullptr;
+	Parser::pushed_back = false;
+	return ok;
+}
 
+bool ProgFromReader(BlockReader& rd, int& line)
+{
+	istream none(nullptr);
+	Parser::reader = &rd;
+	bool ok = ::Prog(none, line);
+	Parser::reader = nullptr;
+	Parser::pushed_back = false;
+	return ok;
+}
 
+bool ProgFromPipe(TokenPipe& pipe, int& line)
+{
+	istream none(nullptr);
+	Parser::tokenPipe = &pipe;
+	bool ok = ::Prog(none, line);
+	Parser::tokenPipe = nullptr;
+	Parser::pushed_back = false;
+	return ok;
+}
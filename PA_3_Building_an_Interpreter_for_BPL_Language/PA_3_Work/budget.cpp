@@ -0,0 +1,31 @@
+/*
+ * budget.cpp
+ * Resource limits for running untrusted BPL scripts
+ * Programming Assignment 3
+ * Fall 2025
+ */
+
+#include <climits>
+
+#include "budget.h"
+
+ScriptBudget Budget;
+long long OpsLeft = LLONG_MAX;
+unsigned long long HeldBytes = 0;
+unsigned long long OutputBytes = 0;
+const char* BudgetError = nullptr;
+
+const char* const OpsBudgetMsg    = "Run-Time Error-Operation budget exceeded";
+const char* const StringBudgetMsg = "Run-Time Error-String size budget exceeded";
+const char* const MemoryBudgetMsg = "Run-Time Error-Memory budget exceeded";
+const char* const OutputBudgetMsg = "Run-Time Error-Output budget exceeded";
+const char* const StringSizeMsg   = "Run-Time Error-String result too large";
+
+void SetBudget(const ScriptBudget& b)
+{
+	Budget = b;
+	OpsLeft = (b.maxOps && b.maxOps < (unsigned long long)LLONG_MAX) ? (long long)b.maxOps : LLONG_MAX;
+	HeldBytes = 0;
+	OutputBytes = 0;
+	BudgetError = nullptr;
+}
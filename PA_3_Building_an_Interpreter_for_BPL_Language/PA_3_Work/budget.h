@@ -0,0 +1,47 @@
+/*
+ * budget.h
+ * Resource limits for running untrusted BPL scripts
+ * Programming Assignment 3
+ * Fall 2025
+*/
+
+#ifndef BUDGET_H_
+#define BUDGET_H_
+
+//Limits for one script; 0 means unlimited
+struct ScriptBudget {
+	unsigned long long maxOps = 0;      // statements and operands evaluated
+	unsigned long long maxMemory = 0;   // bytes of string data held in variables
+	unsigned long long maxString = 0;   // bytes in any single string result
+	unsigned long long maxOutput = 0;   // bytes written by println
+};
+
+extern ScriptBudget Budget;
+extern long long OpsLeft;               // counts down from Budget.maxOps
+extern unsigned long long HeldBytes;    // string bytes currently in variables
+extern unsigned long long OutputBytes;  // bytes printed so far
+
+//Set by Value operations that refused to build an oversized string, so the
+//interpreter can report the budget instead of a type error
+extern const char* BudgetError;
+
+extern const char* const OpsBudgetMsg;
+extern const char* const StringBudgetMsg;
+extern const char* const MemoryBudgetMsg;
+extern const char* const OutputBudgetMsg;
+//for a string no budget allows, one that cannot be held in memory at all
+extern const char* const StringSizeMsg;
+
+extern void SetBudget(const ScriptBudget& b);
+
+inline bool ChargeOp() {
+	return --OpsLeft >= 0;
+}
+
+inline bool StringFits(double bytes) {
+	if (Budget.maxString == 0 || bytes <= (double)Budget.maxString) return true;
+	BudgetError = StringBudgetMsg;
+	return false;
+}
+
+#endif /* BUDGET_H_ */
@@ -0,0 +1,283 @@
+/*
+ * incremental.cpp
+ * Incremental re-execution of BPL programs
+ * Programming Assignment 3
+ * Fall 2025
+ *
+ * The program is parsed into its tree, and each top-level statement is
+ * keyed by its subtree and remembers the variables it read, the values of
+ * the variables it wrote and the output it printed. On a rerun, a
+ * statement whose key matches the previous run and whose reads are all
+ * unaffected by the edit is not executed: its output is replayed and its
+ * writes are installed directly. Everything else runs normally.
+ */
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <cstdio>
+#include <cstdlib>
+
+#include "incremental.h"
+#include "treeexec.h"
+#include "parserInt.h"
+#include "budget.h"
+
+namespace {
+
+const char* CacheMagic = "BPLINC 2";
+
+struct StmtRecord {
+    string key;
+    set<string> reads;
+    map<string, Value> writes;
+    string out;
+};
+
+struct RunCache {
+    bool complete = false;  // previous run reached the end of the program
+    vector<StmtRecord> stmts;
+};
+
+bool SameValue(const Value& a, const Value& b) {
+    if (a.GetType() != b.GetType()) return false;
+    if (a.IsNum()) return a.GetNum() == b.GetNum();
+    if (a.IsString()) return a.GetString() == b.GetString();
+    if (a.IsBool()) return a.GetBool() == b.GetBool();
+    return true;
+}
+
+// Appends the subtree of n to key in preorder, each node with its token
+// and the text it was made from
+void StmtKey(const Ast& ast, const char* text, uint32_t n, string& key) {
+    const AstNode& a = ast[n];
+    key += char('A' + a.kind);
+    key += char('A' + a.op);
+    key += to_string(a.parens);
+    if (a.offset != TokenView::NoOffset)
+        key.append(text + a.offset + (a.op == SCONST), a.length);
+    key += '\x1f';
+    for (uint32_t c = a.first; c != Ast::NoNode; c = ast[c].next)
+        StmtKey(ast, text, c, key);
+    key += '\x1e';
+}
+
+void WriteBlob(ostream& os, const string& s) {
+    os << s.size() << '\n';
+    os.write(s.data(), s.size());
+    os << '\n';
+}
+
+bool ReadBlob(istream& is, string& s) {
+    size_t n;
+    if (!(is >> n)) return false;
+    is.get();
+    s.assign(n, '\0');
+    if (n && !is.read(&s[0], n)) return false;
+    is.get();
+    return true;
+}
+
+void WriteValue(ostream& os, const Value& v) {
+    if (v.IsNum()) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%a", v.GetNum());
+        os << "N " << buf << '\n';
+    }
+    else if (v.IsString()) {
+        os << "S ";
+        WriteBlob(os, v.GetString());
+    }
+    else if (v.IsBool()) {
+        os << "B " << v.GetBool() << '\n';
+    }
+    else {
+        os << "E\n";
+    }
+}
+
+bool ReadValue(istream& is, Value& v) {
+    string kind;
+    if (!(is >> kind)) return false;
+    if (kind == "N") {
+        string num;
+        if (!(is >> num)) return false;
+        v = Value(strtod(num.c_str(), nullptr));
+    }
+    else if (kind == "S") {
+        string s;
+        if (!ReadBlob(is, s)) return false;
+        v = Value(s);
+    }
+    else if (kind == "B") {
+        int b;
+        if (!(is >> b)) return false;
+        v = Value(b != 0);
+    }
+    else {
+        v = Value();
+    }
+    return true;
+}
+
+bool LoadCache(const string& file, RunCache& cache) {
+    ifstream is(file, ios::binary);
+    if (!is.is_open()) return false;
+
+    string magic;
+    getline(is, magic);
+    if (magic != CacheMagic) return false;
+
+    size_t count;
+    if (!(is >> cache.complete >> count)) return false;
+
+    cache.stmts.resize(count);
+    for (StmtRecord& r : cache.stmts) {
+        size_t n;
+        if (!ReadBlob(is, r.key)) return false;
+        if (!(is >> n)) return false;
+        for (size_t i = 0; i < n; i++) {
+            string name;
+            if (!(is >> name)) return false;
+            r.reads.insert(name);
+        }
+        if (!(is >> n)) return false;
+        for (size_t i = 0; i < n; i++) {
+            string name;
+            if (!(is >> name) || !ReadValue(is, r.writes[name])) return false;
+        }
+        if (!ReadBlob(is, r.out)) return false;
+    }
+    return true;
+}
+
+void SaveCache(const string& file, const RunCache& cache) {
+    ofstream os(file, ios::binary | ios::trunc);
+    if (!os.is_open()) return;
+
+    os << CacheMagic << '\n' << cache.complete << ' ' << cache.stmts.size() << '\n';
+    for (const StmtRecord& r : cache.stmts) {
+        WriteBlob(os, r.key);
+        os << r.reads.size();
+        for (const string& name : r.reads) os << ' ' << name;
+        os << '\n' << r.writes.size() << '\n';
+        for (const auto& w : r.writes) {
+            os << w.first << ' ';
+            WriteValue(os, w.second);
+        }
+        WriteBlob(os, r.out);
+    }
+}
+
+} // namespace
+
+bool ProgIncremental(SourceBuffer& src, int& line, const string& cacheFile) {
+
+    // A program with a syntax error runs as ProgFromTree runs it, and the
+    // cache is left for the next run.
+    Ast ast;
+    vector<Diagnostic> errors;
+    int first = line;
+    if (!ParseProg(src, line, ast, errors)) {
+        line = first;
+        return ProgFromSource(src, line);
+    }
+    TreeRun run(ast, src);
+
+    vector<string> keys;
+    vector<uint32_t> stmts;
+    for (uint32_t s = ast[ast.Root()].first; s != Ast::NoNode; s = ast[s].next) {
+        stmts.push_back(s);
+        keys.emplace_back();
+        StmtKey(ast, src.Begin(), s, keys.back());
+    }
+
+    RunCache prev, next;
+    if (!LoadCache(cacheFile, prev)) prev = RunCache();
+
+    // Pair statements with the previous run by common prefix and suffix.
+    size_t oldN = prev.stmts.size(), newN = stmts.size();
+    size_t pre = 0, suf = 0;
+    while (pre < oldN && pre < newN && prev.stmts[pre].key == keys[pre])
+        pre++;
+    if (prev.complete) {
+        while (suf < oldN - pre && suf < newN - pre &&
+               prev.stmts[oldN - 1 - suf].key == keys[newN - 1 - suf])
+            suf++;
+    }
+
+    // Variables whose value may differ from the previous run at this point.
+    set<string> dirty;
+
+    for (size_t j = 0; j < newN; j++) {
+        if (j == pre && prev.complete) {
+            for (size_t k = pre; k < oldN - suf; k++)
+                for (const auto& w : prev.stmts[k].writes) dirty.insert(w.first);
+        }
+
+        const StmtRecord* old = nullptr;
+        if (j < pre) old = &prev.stmts[j];
+        else if (j >= newN - suf) old = &prev.stmts[j - newN + oldN];
+
+        bool reuse = old != nullptr;
+        if (reuse) {
+            for (const string& r : old->reads)
+                if (dirty.count(r)) { reuse = false; break; }
+        }
+        // output that would go over the budget is made again, so the run
+        // stops at the println that goes over, as it does without a cache
+        if (reuse && Budget.maxOutput && OutputBytes + old->out.size() > Budget.maxOutput)
+            reuse = false;
+
+        if (reuse) {
+            if (Budget.maxOutput) OutputBytes += old->out.size();
+            cout << old->out;
+            for (const auto& w : old->writes) {
+                run.Set(w.first, w.second);
+                dirty.erase(w.first);
+            }
+            next.stmts.push_back(*old);
+            continue;
+        }
+
+        StmtTrace trace;
+        ostringstream captured;
+        streambuf* saved = cout.rdbuf(captured.rdbuf());
+
+        run.SetTrace(&trace);
+        bool ok = run.Stmt(stmts[j]);
+        run.SetTrace(nullptr);
+        cout.rdbuf(saved);
+        cout << captured.str();
+
+        if (!ok) {
+            SaveCache(cacheFile, next);
+            return FinishProg(false);
+        }
+
+        StmtRecord rec;
+        rec.key = keys[j];
+        rec.reads.swap(trace.reads);
+        rec.out = captured.str();
+        for (const string& w : trace.writes) {
+            const Value& v = rec.writes[w] = *run.Get(w);
+            bool same = false;
+            if (old) {
+                auto ow = old->writes.find(w);
+                same = ow != old->writes.end() && SameValue(ow->second, v);
+            }
+            if (same) dirty.erase(w);
+            else dirty.insert(w);
+        }
+        if (old) {
+            for (const auto& w : old->writes)
+                if (!trace.writes.count(w.first)) dirty.insert(w.first);
+        }
+        next.stmts.push_back(rec);
+    }
+
+    next.complete = true;
+    SaveCache(cacheFile, next);
+    return FinishProg(true);
+}
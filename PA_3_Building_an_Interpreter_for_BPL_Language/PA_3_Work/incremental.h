@@ -0,0 +1,22 @@
+/*
+ * incremental.h
+ * Incremental re-execution of BPL programs
+ * Programming Assignment 3
+ * Fall 2025
+*/
+
+#ifndef INCREMENTAL_H_
+#define INCREMENTAL_H_
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+#include "lex.h"
+
+//Runs the program like ProgFromTree, reusing the results of unchanged statements
+//recorded in cacheFile by a previous run, then rewrites the cache.
+extern bool ProgIncremental(SourceBuffer& src, int& line, const string& cacheFile);
+
+#endif /* INCREMENTAL_H_ */
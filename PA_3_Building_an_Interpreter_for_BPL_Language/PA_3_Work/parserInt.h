@@ -14,6 +14,8 @@ using namespace std;
 #include "lex.h"
 #include "val.h"
 
+class TokenPipe;
+
 
 extern bool Prog(istream& in, int& line);
 extern bool StmtList(istream& in, int& line);
@@ -34,4 +36,15 @@ extern bool ExponExpr(istream& in, int& line, int sign, Value & retVal);
 extern bool PrimaryExpr(istream& in, int& line, int sign, Value & retVal);
 extern int ErrCount();
 
+//Runs the program in src with Prog, lexing it from memory. Prog runs each
+//statement as soon as it has parsed it, and skips the branch of an if that
+//is not taken without parsing it; this is how prog3 has always reported a
+//program with a syntax error.
+extern bool ProgFromSource(const SourceBuffer& src, int& line);
+//The same for a program read from a pipe or stdin a block at a time; each
+//statement runs before the input after it is read
+extern bool ProgFromReader(BlockReader& rd, int& line);
+//The same with the input read and lexed on the pipe's thread
+extern bool ProgFromPipe(TokenPipe& pipe, int& line);
+
 #endif /* PARSEINT_H_ */
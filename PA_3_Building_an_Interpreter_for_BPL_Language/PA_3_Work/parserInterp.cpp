@@ -1,41 +1,64 @@
 #include <iostream>
 #include <map>
 #include <queue>
+#include <sstream>
 #include "parserInt.h"
 #include "lex.h"
 #include "val.h"
+#include "profile.h"
+#include "budget.h"
+#include "rulestats.h"
 
 using namespace std;
 
 extern void ParseError(int line, string msg);
 extern int ErrCount();
 
-extern map<string, bool> defVar;
-extern map<string, Value> TempsResults;
-extern queue<Value>* ValQue;
+extern map<string, bool, less<>> defVar;
+extern map<string, Value, less<>> TempsResults;
+extern vector<Value> ValQue;
 
 namespace Parser {
-    extern bool pushed_back;
-    extern LexItem pushed_token;
-    extern LexItem GetNextToken(istream& in, int& line);
-    extern void PushBackToken(LexItem& t);
+    extern const LexItem& GetNextToken(istream& in, int& line);
+    extern const LexItem& PeekToken(istream& in, int& line);
+    extern void PushBackToken(const LexItem& t);
 }
 
-static bool IsDefined(const string& name) {
+static bool IsDefined(string_view name) {
     return TempsResults.find(name) != TempsResults.end();
 }
 
+// Variable storage for name, created on first assignment
+static Value& VarSlot(string_view name) {
+    auto it = TempsResults.find(name);
+    if (it == TempsResults.end())
+        it = TempsResults.emplace(string(name), Value()).first;
+    return it->second;
+}
+
 static bool BplTruth(const Value& v) {
     if (v.IsNum()) return v.GetNum() != 0.0;
     if (v.IsString()) {
-        string s = v.GetString();
+        const string& s = v.GetString();
         return !(s == "" || s == "0");
     }
     if (v.IsBool()) return v.GetBool();
     return false;
 }
 
+// Reports a failed Value operation, preferring a budget refusal over msg.
+static void OpError(int line, const string& msg) {
+    if (BudgetError) {
+        ParseError(line, BudgetError);
+        BudgetError = nullptr;
+    }
+    else {
+        ParseError(line, msg);
+    }
+}
+
 bool Prog(istream& in, int& line) {
+    RULE_SCOPE(R_PROG);
 
     if (!StmtList(in, line)) {
         cout << "\nUnsuccessful Interpretation" << endl;
@@ -57,31 +80,34 @@ bool Prog(istream& in, int& line) {
 }
 
 bool StmtList(istream& in, int& line) {
+    RULE_SCOPE(R_STMTLIST);
 
-    if (!Stmt(in, line)) return false;
+    //one statement per iteration, so long programs do not grow the stack
+    while (true) {
+        if (!Stmt(in, line)) return false;
 
-    LexItem tok = Parser::GetNextToken(in, line);
+        if (Parser::PeekToken(in, line).GetToken() != SEMICOL)
+            return true;
+        Parser::GetNextToken(in, line);
 
-    if (tok.GetToken() != SEMICOL) {
-        Parser::PushBackToken(tok);
-        return true;
-    }
-
-    tok = Parser::GetNextToken(in, line);
-    Parser::PushBackToken(tok);
-
-    Token nxt = tok.GetToken();
+        Token nxt = Parser::PeekToken(in, line).GetToken();
 
-    if (nxt == IDENT || nxt == IF || nxt == PRINTLN)
-        return StmtList(in, line);
-
-    return true;
+        if (nxt != IDENT && nxt != IF && nxt != PRINTLN)
+            return true;
+    }
 }
 
 bool Stmt(istream& in, int& line) {
+    RULE_SCOPE(R_STMT);
 
-    LexItem t = Parser::GetNextToken(in, line);
-    Parser::PushBackToken(t);
+    const LexItem& t = Parser::PeekToken(in, line);
+
+    if (!ChargeOp()) {
+        ParseError(line, OpsBudgetMsg);
+        return false;
+    }
+
+    ProfScope prof(t.GetToken(), t.GetLinenum());
 
     switch (t.GetToken()) {
         case IF:        return IfStmt(in, line);
@@ -94,6 +120,7 @@ bool Stmt(istream& in, int& line) {
 }
 
 bool PrintLnStmt(istream& in, int& line) {
+    RULE_SCOPE(R_PRINTLN);
 
     Parser::GetNextToken(in, line);
 
@@ -102,35 +129,39 @@ bool PrintLnStmt(istream& in, int& line) {
         return false;
     }
 
-    ValQue = new queue<Value>();
+    //a PrintLn never holds another, so one list serves them all and keeps
+    //its storage from the last one
+    ValQue.clear();
 
     if (!ExprList(in, line)) {
-        delete ValQue;
-        ValQue = nullptr;
         ParseError(line, "Invalid expression list in PrintLn");
         return false;
     }
 
     if (Parser::GetNextToken(in, line).GetToken() != RPAREN) {
-        delete ValQue;
-        ValQue = nullptr;
         ParseError(line, "Missing ')' in PrintLn");
         return false;
     }
 
-    while (!ValQue->empty()) {
-        cout << ValQue->front();
-        ValQue->pop();
+    if (Budget.maxOutput) {
+        ostringstream text;
+        for (const Value& v : ValQue) text << v;
+        OutputBytes += text.str().size() + 1;
+        if (OutputBytes > Budget.maxOutput) {
+            ParseError(line, OutputBudgetMsg);
+            return false;
+        }
+        cout << text.str() << endl;
+        return true;
     }
-    cout << endl;
-
-    delete ValQue;
-    ValQue = nullptr;
 
+    for (const Value& v : ValQue) cout << v;
+    cout << endl;
     return true;
 }
 
 bool IfStmt(istream& in, int& line) {
+    RULE_SCOPE(R_IF);
 
     Parser::GetNextToken(in, line);
 
@@ -164,6 +195,7 @@ bool IfStmt(istream& in, int& line) {
     else {
         int bc = 1;
         while (bc > 0) {
+            RULE_SKIP();
             LexItem x = Parser::GetNextToken(in, line);
             Token tk = x.GetToken();
 
@@ -184,9 +216,8 @@ bool IfStmt(istream& in, int& line) {
         }
     }
 
-    LexItem nxt = Parser::GetNextToken(in, line);
-
-    if (nxt.GetToken() == ELSE) {
+    if (Parser::PeekToken(in, line).GetToken() == ELSE) {
+        Parser::GetNextToken(in, line);
         if (Parser::GetNextToken(in, line).GetToken() != LBRACES) {
             ParseError(line, "Missing '{' in Else clause");
             return false;
@@ -204,6 +235,7 @@ bool IfStmt(istream& in, int& line) {
         else {
             int bc = 1;
             while (bc > 0) {
+                RULE_SKIP();
                 LexItem x = Parser::GetNextToken(in, line);
                 Token tk = x.GetToken();
 
@@ -216,14 +248,12 @@ bool IfStmt(istream& in, int& line) {
             }
         }
     }
-    else {
-        Parser::PushBackToken(nxt);
-    }
 
     return true;
 }
 
 bool AssignStmt(istream& in, int& line) {
+    RULE_SCOPE(R_ASSIGN);
 
     LexItem var = Parser::GetNextToken(in, line);
     if (var.GetToken() != IDENT) {
@@ -231,7 +261,8 @@ bool AssignStmt(istream& in, int& line) {
         return false;
     }
 
-    defVar[var.GetLexeme()] = true;
+    string_view name = var.GetLexemeView();
+    if (defVar.find(name) == defVar.end()) defVar.emplace(string(name), true);
 
     LexItem op = Parser::GetNextToken(in, line);
     Token optok = op.GetToken();
@@ -253,66 +284,78 @@ bool AssignStmt(istream& in, int& line) {
             ParseError(line, "Run-Time Error-Illegal assignment of Boolean");
             return false;
         }
-        ans = rval;
+        ans = move(rval);
     }
     else if (optok == CADDA) {
-        if (!IsDefined(var.GetLexeme())) {
+        if (!IsDefined(name)) {
             ParseError(line, "Using Undefined Variable: " + var.GetLexeme());
             return false;
         }
-        ans = TempsResults[var.GetLexeme()] + rval;
+        ans = VarSlot(name) + rval;
     }
     else if (optok == CSUBA) {
-        if (!IsDefined(var.GetLexeme())) {
+        if (!IsDefined(name)) {
             ParseError(line, "Using Undefined Variable: " + var.GetLexeme());
             return false;
         }
-        ans = TempsResults[var.GetLexeme()] - rval;
+        ans = VarSlot(name) - rval;
     }
     else if (optok == CCATA) {
-        if (!IsDefined(var.GetLexeme())) {
+        if (!IsDefined(name)) {
             ParseError(line, "Using Undefined Variable: " + var.GetLexeme());
             return false;
         }
-        ans = TempsResults[var.GetLexeme()].Catenate(rval);
+        ans = VarSlot(name).Catenate(rval);
+        if (ProfileOn) ProfAddBytes(ans.GetString().size());
     }
 
     if (ans.IsErr()) {
-        ParseError(line, "Run-Time Error-Illegal Assignment Operation");
+        OpError(line, "Run-Time Error-Illegal Assignment Operation");
         return false;
     }
 
-    TempsResults[var.GetLexeme()] = ans;
+    if (Budget.maxMemory) {
+        auto cur = TempsResults.find(name);
+        unsigned long long held = HeldBytes + ans.StringSize();
+        if (cur != TempsResults.end()) held -= cur->second.StringSize();
+        if (held > Budget.maxMemory) {
+            ParseError(line, MemoryBudgetMsg);
+            return false;
+        }
+        HeldBytes = held;
+    }
+
+    VarSlot(name) = move(ans);
     return true;
 }
 
 bool ExprList(istream& in, int& line) {
-    Value v;
+    RULE_SCOPE(R_EXPRLIST);
 
-    if (!Expr(in, line, v)) return false;
-    ValQue->push(v);
+    //each value is worked out in its place in the list
+    ValQue.emplace_back();
+    if (!Expr(in, line, ValQue.back())) return false;
 
-    LexItem t = Parser::GetNextToken(in, line);
-    while (t.GetToken() == COMMA) {
-        if (!Expr(in, line, v)) return false;
-        ValQue->push(v);
-        t = Parser::GetNextToken(in, line);
+    while (Parser::PeekToken(in, line).GetToken() == COMMA) {
+        Parser::GetNextToken(in, line);
+        ValQue.emplace_back();
+        if (!Expr(in, line, ValQue.back())) return false;
     }
-
-    Parser::PushBackToken(t);
     return true;
 }
 
 bool Expr(istream& in, int& line, Value &retVal) {
+    RULE_SCOPE(R_EXPR);
     return OrExpr(in, line, retVal);
 }
 
 bool OrExpr(istream& in, int& line, Value &retVal) {
+    RULE_SCOPE(R_OR);
 
     if (!AndExpr(in, line, retVal)) return false;
 
-    LexItem t = Parser::GetNextToken(in, line);
-    while (t.GetToken() == OR) {
+    while (Parser::PeekToken(in, line).GetToken() == OR) {
+        Parser::GetNextToken(in, line);
 
         Value rhs;
         if (!AndExpr(in, line, rhs)) {
@@ -325,20 +368,17 @@ bool OrExpr(istream& in, int& line, Value &retVal) {
             ParseError(line, "Run-Time Error-Illegal OR Operation");
             return false;
         }
-
-        t = Parser::GetNextToken(in, line);
     }
-
-    Parser::PushBackToken(t);
     return true;
 }
 
 bool AndExpr(istream& in, int& line, Value &retVal) {
+    RULE_SCOPE(R_AND);
 
     if (!RelExpr(in, line, retVal)) return false;
 
-    LexItem t = Parser::GetNextToken(in, line);
-    while (t.GetToken() == AND) {
+    while (Parser::PeekToken(in, line).GetToken() == AND) {
+        Parser::GetNextToken(in, line);
 
         Value rhs;
         if (!RelExpr(in, line, rhs)) {
@@ -351,21 +391,18 @@ bool AndExpr(istream& in, int& line, Value &retVal) {
             ParseError(line, "Run-Time Error-Illegal AND Operation");
             return false;
         }
-
-        t = Parser::GetNextToken(in, line);
     }
-
-    Parser::PushBackToken(t);
     return true;
 }
 
 bool RelExpr(istream& in, int& line, Value &retVal) {
+    RULE_SCOPE(R_REL);
 
     if (!AddExpr(in, line, retVal)) return false;
 
     LexItem op = Parser::GetNextToken(in, line);
     Token t = op.GetToken();
-    string lex = op.GetLexeme();
+    string_view lex = op.GetLexemeView();
 
     if (t == SEQ || t == SLTE || t == SGT) {
 
@@ -390,7 +427,7 @@ bool RelExpr(istream& in, int& line, Value &retVal) {
             return false;
         }
 
-        retVal = result;
+        retVal = move(result);
         return true;
     }
 
@@ -417,7 +454,7 @@ bool RelExpr(istream& in, int& line, Value &retVal) {
             return false;
         }
 
-        retVal = result;
+        retVal = move(result);
         return true;
     }
 
@@ -426,12 +463,11 @@ bool RelExpr(istream& in, int& line, Value &retVal) {
 }
 
 bool AddExpr(istream& in, int& line, Value &retVal) {
+    RULE_SCOPE(R_ADD);
     if (!MultExpr(in, line, retVal)) return false;
 
-    LexItem t = Parser::GetNextToken(in, line);
-    while (t.GetToken() == PLUS || t.GetToken() == MINUS || t.GetToken() == CAT) {
-
-        Token op = t.GetToken();
+    for (Token op; (op = Parser::PeekToken(in, line).GetToken()) == PLUS || op == MINUS || op == CAT; ) {
+        Parser::GetNextToken(in, line);
         Value rhs;
 
         if (!MultExpr(in, line, rhs)) {
@@ -452,26 +488,24 @@ bool AddExpr(istream& in, int& line, Value &retVal) {
                            retVal.Catenate(rhs)));
 
         if (ans.IsErr()) {
-            ParseError(line, "Run-Time Error-Illegal Additive Operation");
+            OpError(line, "Run-Time Error-Illegal Additive Operation");
             return false;
         }
+        if (ProfileOn && op == CAT) ProfAddBytes(ans.GetString().size());
 
-        retVal = ans;
-        t = Parser::GetNextToken(in, line);
+        retVal = move(ans);
     }
-
-    Parser::PushBackToken(t);
     return true;
 }
 
 bool MultExpr(istream& in, int& line, Value &retVal) {
+    RULE_SCOPE(R_MULT);
     if (!UnaryExpr(in, line, retVal)) return false;
 
-    LexItem t = Parser::GetNextToken(in, line);
-    while (t.GetToken() == MULT || t.GetToken() == DIV ||
-           t.GetToken() == REM || t.GetToken() == SREPEAT)
+    for (Token op; (op = Parser::PeekToken(in, line).GetToken()) == MULT || op == DIV ||
+                   op == REM || op == SREPEAT; )
     {
-        Token op = t.GetToken();
+        Parser::GetNextToken(in, line);
         Value rhs;
 
         if (!UnaryExpr(in, line, rhs)) {
@@ -517,21 +551,19 @@ bool MultExpr(istream& in, int& line, Value &retVal) {
                            retVal.Repeat(rhs))));
 
         if (ans.IsErr()) {
-            ParseError(line, "Run-Time Error-Illegal Multiplicative Operation");
+            OpError(line, "Run-Time Error-Illegal Multiplicative Operation");
             return false;
         }
+        if (ProfileOn && op == SREPEAT) ProfAddBytes(ans.GetString().size());
 
-        retVal = ans;
-        t = Parser::GetNextToken(in, line);
+        retVal = move(ans);
     }
-
-    Parser::PushBackToken(t);
     return true;
 }
 
 bool UnaryExpr(istream& in, int& line, Value &retVal) {
-    LexItem t = Parser::GetNextToken(in, line);
-    Token tok = t.GetToken();
+    RULE_SCOPE(R_UNARY);
+    Token tok = Parser::PeekToken(in, line).GetToken();
 
     int sign = +1;
     bool isNot = false;
@@ -539,7 +571,7 @@ bool UnaryExpr(istream& in, int& line, Value &retVal) {
     if (tok == MINUS) sign = -1;
     else if (tok == PLUS) sign = +1;
     else if (tok == NOT) isNot = true;
-    else Parser::PushBackToken(t);
+    if (tok == MINUS || tok == PLUS || tok == NOT) Parser::GetNextToken(in, line);
 
     if (!ExponExpr(in, line, sign, retVal)) return false;
 
@@ -556,13 +588,11 @@ bool UnaryExpr(istream& in, int& line, Value &retVal) {
 }
 
 bool ExponExpr(istream& in, int& line, int sign, Value &retVal) {
+    RULE_SCOPE(R_EXPON);
     if (!PrimaryExpr(in, line, sign, retVal)) return false;
 
-    LexItem t = Parser::GetNextToken(in, line);
-    if (t.GetToken() != EXPONENT) {
-        Parser::PushBackToken(t);
-        return true;
-    }
+    if (Parser::PeekToken(in, line).GetToken() != EXPONENT) return true;
+    Parser::GetNextToken(in, line);
 
     Value rhs;
     if (!ExponExpr(in, line, +1, rhs)) {
@@ -586,16 +616,23 @@ bool ExponExpr(istream& in, int& line, int sign, Value &retVal) {
 }
 
 bool PrimaryExpr(istream& in, int& line, int sign, Value &retVal) {
+    RULE_SCOPE(R_PRIMARY);
     LexItem t = Parser::GetNextToken(in, line);
     Token tt = t.GetToken();
 
+    if (!ChargeOp()) {
+        ParseError(line, OpsBudgetMsg);
+        return false;
+    }
+
     if (tt == IDENT) {
-        string var = t.GetLexeme();
-        if (!IsDefined(var)) {
-            ParseError(line, "Using Undefined Variable: " + var);
+        string_view var = t.GetLexemeView();
+        auto it = TempsResults.find(var);
+        if (it == TempsResults.end()) {
+            ParseError(line, "Using Undefined Variable: " + t.GetLexeme());
             return false;
         }
-        retVal = TempsResults[var];
+        retVal = it->second;
         if (sign == -1) {
             if (!retVal.IsNum()) {
                 ParseError(line, "Run-Time Error-Illegal operand type for sign operation");
@@ -606,13 +643,8 @@ bool PrimaryExpr(istream& in, int& line, int sign, Value &retVal) {
         return true;
     }
 
-    if (tt == ICONST) {
-        retVal = Value(sign * stod(t.GetLexeme()));
-        return true;
-    }
-
-    if (tt == FCONST) {
-        retVal = Value(sign * stod(t.GetLexeme()));
+    if (tt == ICONST || tt == FCONST) {
+        retVal = Value(sign * t.GetNumber());
         return true;
     }
 
@@ -622,6 +654,7 @@ bool PrimaryExpr(istream& in, int& line, int sign, Value &retVal) {
             return false;
         }
         retVal = Value(t.GetLexeme());
+        if (ProfileOn) ProfAddBytes(t.GetLexemeView().size());
         return true;
     }
 
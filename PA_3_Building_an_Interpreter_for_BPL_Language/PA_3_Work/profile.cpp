@@ -0,0 +1,188 @@
+/*
+ * profile.cpp
+ * Statement profiler for the BPL interpreter
+ * Programming Assignment 3
+ * Fall 2025
+ *
+ * Statistics are kept per (statement kind, source line). Call paths are kept
+ * in a small trie so that the folded-stack output does not need to build a
+ * path string on every statement.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#include "profile.h"
+
+bool ProfileOn = false;
+
+namespace {
+
+typedef unsigned long long u64;
+
+struct ProfStat {
+	Token kind;
+	int line;
+	u64 count = 0;
+	u64 totalNs = 0;
+	u64 selfNs = 0;
+	u64 strBytes = 0;
+	int active = 0;     // nesting depth of this (kind, line) on the stack
+};
+
+struct PathNode {
+	int parent;
+	int stat;
+	u64 selfNs = 0;
+	unordered_map<u64, int> kids;
+};
+
+struct Frame {
+	int stat;
+	int path;
+	u64 start;
+	u64 childNs;
+};
+
+vector<ProfStat> stats;
+unordered_map<u64, int> statIndex;
+vector<PathNode> paths(1, PathNode{ -1, -1, 0, {} });
+vector<Frame> stack;
+
+inline u64 NowNs() {
+	return chrono::duration_cast<chrono::nanoseconds>(
+		chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline u64 StatKey(Token stmt, int line) {
+	return ((u64)(unsigned)line << 8) | (u64)stmt;
+}
+
+const char* KindName(Token stmt) {
+	switch (stmt) {
+	case IF:      return "IfStmt";
+	case PRINTLN: return "PrintLnStmt";
+	case IDENT:   return "AssignStmt";
+	default:      return "Stmt";
+	}
+}
+
+string PathString(int node) {
+	string path;
+	for (; node > 0; node = paths[node].parent) {
+		const ProfStat& s = stats[paths[node].stat];
+		string frame = string(KindName(s.kind)) + ":" + to_string(s.line);
+		path = path.empty() ? frame : frame + ";" + path;
+	}
+	return "Prog;" + path;
+}
+
+} // namespace
+
+void ProfEnter(Token stmt, int line) {
+	u64 key = StatKey(stmt, line);
+	auto it = statIndex.find(key);
+	int si;
+	if (it == statIndex.end()) {
+		si = (int)stats.size();
+		statIndex.emplace(key, si);
+		stats.push_back(ProfStat());
+		stats.back().kind = stmt;
+		stats.back().line = line;
+	}
+	else {
+		si = it->second;
+	}
+
+	int parent = stack.empty() ? 0 : stack.back().path;
+	auto kid = paths[parent].kids.find((u64)si);
+	int node;
+	if (kid == paths[parent].kids.end()) {
+		node = (int)paths.size();
+		paths[parent].kids.emplace((u64)si, node);
+		paths.push_back(PathNode{ parent, si, 0, {} });
+	}
+	else {
+		node = kid->second;
+	}
+
+	stats[si].active++;
+	stack.push_back(Frame{ si, node, NowNs(), 0 });
+}
+
+void ProfExit() {
+	u64 end = NowNs();
+	Frame f = stack.back();
+	stack.pop_back();
+
+	u64 total = end - f.start;
+	u64 self = total > f.childNs ? total - f.childNs : 0;
+
+	ProfStat& s = stats[f.stat];
+	s.count++;
+	s.selfNs += self;
+	if (--s.active == 0) s.totalNs += total;
+	paths[f.path].selfNs += self;
+
+	if (!stack.empty()) stack.back().childNs += total;
+}
+
+void ProfAddBytes(size_t n) {
+	if (!stack.empty()) stats[stack.back().stat].strBytes += n;
+}
+
+bool ProfWriteReport(const string& prefix) {
+	ofstream rep(prefix + ".prof");
+	ofstream fold(prefix + ".folded");
+	if (!rep.is_open() || !fold.is_open()) return false;
+
+	vector<int> order(stats.size());
+	for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+	sort(order.begin(), order.end(), [](int a, int b) {
+		if (stats[a].selfNs != stats[b].selfNs) return stats[a].selfNs > stats[b].selfNs;
+		return stats[a].line < stats[b].line;
+	});
+
+	struct KindTotal { u64 count = 0, selfNs = 0, strBytes = 0; };
+	KindTotal kinds[3];
+	u64 allSelf = 0;
+	for (const ProfStat& s : stats) {
+		KindTotal& k = kinds[s.kind == IF ? 0 : (s.kind == PRINTLN ? 1 : 2)];
+		k.count += s.count;
+		k.selfNs += s.selfNs;
+		k.strBytes += s.strBytes;
+		allSelf += s.selfNs;
+	}
+
+	rep << fixed << setprecision(3);
+	rep << "By statement kind:" << endl;
+	rep << setw(14) << "Kind" << setw(12) << "Count" << setw(14) << "Self(ms)"
+		<< setw(14) << "StrBytes" << endl;
+	const Token kindTok[3] = { IF, PRINTLN, IDENT };
+	for (int k = 0; k < 3; k++) {
+		rep << setw(14) << KindName(kindTok[k]) << setw(12) << kinds[k].count
+			<< setw(14) << kinds[k].selfNs / 1e6 << setw(14) << kinds[k].strBytes << endl;
+	}
+
+	rep << endl << "By source line (sorted by self time, total " << allSelf / 1e6 << " ms):" << endl;
+	rep << setw(8) << "Line" << setw(14) << "Kind" << setw(12) << "Count"
+		<< setw(14) << "Total(ms)" << setw(14) << "Self(ms)" << setw(8) << "Self%"
+		<< setw(14) << "StrBytes" << endl;
+	for (int i : order) {
+		const ProfStat& s = stats[i];
+		rep << setw(8) << s.line << setw(14) << KindName(s.kind) << setw(12) << s.count
+			<< setw(14) << s.totalNs / 1e6 << setw(14) << s.selfNs / 1e6
+			<< setw(8) << setprecision(1) << (allSelf ? 100.0 * s.selfNs / allSelf : 0.0)
+			<< setprecision(3) << setw(14) << s.strBytes << endl;
+	}
+
+	for (size_t n = 1; n < paths.size(); n++) {
+		u64 us = paths[n].selfNs / 1000;
+		if (us) fold << PathString((int)n) << ' ' << us << '\n';
+	}
+	return true;
+}
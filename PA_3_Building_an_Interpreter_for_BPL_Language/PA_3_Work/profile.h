@@ -0,0 +1,45 @@
+/*
+ * profile.h
+ * Statement profiler for the BPL interpreter
+ * Programming Assignment 3
+ * Fall 2025
+*/
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <string>
+
+using namespace std;
+
+#include "lex.h"
+
+//Set by prog3 -profile; every hook below is a single test when it is off
+extern bool ProfileOn;
+
+extern void ProfEnter(Token stmt, int line);
+extern void ProfExit();
+
+//Charges n bytes of freshly built string result to the running statement
+extern void ProfAddBytes(size_t n);
+
+//Writes <prefix>.prof (report sorted by self time) and <prefix>.folded
+//(one "frame;frame;... value" line per call path, self time in microseconds)
+extern bool ProfWriteReport(const string& prefix);
+
+//Times one statement execution; nested statements are charged to their parent
+//only as child time, so self time excludes them.
+class ProfScope {
+	bool active;
+
+public:
+	ProfScope(Token stmt, int line)
+		: active(ProfileOn && (stmt == IF || stmt == PRINTLN || stmt == IDENT)) {
+		if (active) ProfEnter(stmt, line);
+	}
+	~ProfScope() {
+		if (active) ProfExit();
+	}
+};
+
+#endif /* PROFILE_H_ */
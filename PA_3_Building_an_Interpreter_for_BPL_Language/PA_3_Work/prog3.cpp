@@ -8,9 +8,21 @@
 
 #include <iostream>
 #include <fstream>
+#include <cstdlib>
+#include <memory>
+#include <fcntl.h>
+#include <unistd.h>
 
 
+#include "parser.h"
 #include "parserInt.h"
+#include "incremental.h"
+#include "profile.h"
+#include "tokpipe.h"
+#include "lexpar.h"
+#include "tokcache.h"
+#include "budget.h"
+#include "treeexec.h"
 
 
 using namespace std;
@@ -20,39 +32,185 @@ int main(int argc, char *argv[])
 	int lineNumber = 1;
 
 	istream *in = NULL;
-	ifstream file;
+	SourceBuffer source;
+	BlockReader stdinReader(0);
+	bool fromStdin = false;
+	int fileFd = -1;
+	string incrCache;
+	string tokCache;
+	string astFile;
+	string fileName;
+	bool pipelined = false;
+	bool parallelLex = false;
+	bool columns = false;
+	bool tableParser = false;
+	ScriptBudget budget;
 		
 	for( int i=1; i<argc; i++ )
     {
 		string arg = argv[i];
 		
-		if( in != NULL ) 
+		if( arg == "-incr" )
+		{
+			if( i + 1 >= argc )
+			{
+				cerr << "MISSING CACHE FILE NAME" << endl;
+				return 0;
+			}
+			incrCache = argv[++i];
+		}
+		else if( arg == "-tokcache" )
+		{
+			if( i + 1 >= argc )
+			{
+				cerr << "MISSING TOKEN CACHE FILE NAME" << endl;
+				return 0;
+			}
+			tokCache = argv[++i];
+		}
+		else if( arg == "-ast" )
+		{
+			if( i + 1 >= argc )
+			{
+				cerr << "MISSING AST FILE NAME" << endl;
+				return 0;
+			}
+			astFile = argv[++i];
+		}
+		else if( arg == "-profile" )
+		{
+			ProfileOn = true;
+		}
+		else if( arg == "-pipe" )
+		{
+			pipelined = true;
+		}
+		else if( arg == "-plex" )
+		{
+			parallelLex = true;
+		}
+		else if( arg == "-col" )
+		{
+			columns = true;
+		}
+		else if( arg == "-ll1" )
+		{
+			tableParser = true;
+		}
+		else if( arg == "-maxops" || arg == "-maxmem" || arg == "-maxstr" || arg == "-maxout" )
+		{
+			if( i + 1 >= argc )
+			{
+				cerr << "MISSING LIMIT FOR " << arg << endl;
+				return 0;
+			}
+			unsigned long long limit = strtoull(argv[++i], NULL, 10);
+			if( arg == "-maxops" ) budget.maxOps = limit;
+			else if( arg == "-maxmem" ) budget.maxMemory = limit;
+			else if( arg == "-maxstr" ) budget.maxString = limit;
+			else budget.maxOutput = limit;
+		}
+		else if( in != NULL ) 
         {
 			cerr << "ONLY ONE FILE NAME ALLOWED" << endl;
 			return 0;
 		}
+		else if( arg == "-" )
+		{
+			in = &cin;
+			fromStdin = true;
+			fileName = "stdin";
+		}
 		else 
         {
-			file.open(arg.c_str());
-			if( file.is_open() == false ) 
+			fileFd = open(arg.c_str(), O_RDONLY);
+			if( fileFd < 0 ) 
             {
 				cerr << "CANNOT OPEN " << arg << endl;
 				return 0;
 			}
 
-			in = &file;
+			in = &source.Stream();
+			fileName = arg;
 		}
 	}
-    if(argc == 1)
+    if(in == NULL)
 	{
 		cerr << "Missing File Name." << endl;
 		return 0;
 	}
 	
-    bool status = Prog(*in, lineNumber);
+    SetBudget(budget);
+	
+    //these need the whole program in memory, so stdin is read first and
+    //-pipe is not used; otherwise stdin is run by the one-pass interpreter
+    //as it is read
+    bool whole = !incrCache.empty() || !tokCache.empty() || !astFile.empty() || parallelLex || tableParser;
+    pipelined = pipelined && !whole;
+
+    //with -pipe a file is read a block at a time on the lexer thread; it is
+    //mapped too only for the line table -col needs
+    if( fromStdin && (whole || columns) )
+	{
+		source.ReadStream(cin);
+		fromStdin = pipelined = false;
+	}
+	else if( !fromStdin && (!pipelined || columns) && !source.OpenFile(fileName) )
+	{
+		cerr << "CANNOT OPEN " << fileName << endl;
+		return 0;
+	}
+    BlockReader fileReader(fileFd);
+
+    //tokens saved by an earlier prog2 or prog3 run over the same source
+    TokenCache cache(source);
+    if( !tokCache.empty() )
+	{
+		bool cached = cache.Load(tokCache);
+		if( !cached && (cached = cache.Build()) && !cache.Save(tokCache) )
+			cerr << "CANNOT WRITE TOKEN CACHE " << tokCache << endl;
+		if( cached )
+			SetTokenCache(&cache);
+	}
+    if( columns )
+		SetErrorColumns(source.Lines());
+    if( tableParser )
+		SetParseEngine(ENGINE_LL1);
+
+    unique_ptr<ParallelLexer> lexer;
+    if( parallelLex && source.Lines() )
+	{
+		lexer.reset(new ParallelLexer(*source.Lines(), source.Begin(), source.End()));
+		SetChunkLexer(lexer.get());
+	}
+
+    bool status;
+    if( !incrCache.empty() )
+		status = ProgIncremental(source, lineNumber, incrCache);
+	else if( pipelined )
+	{
+		TokenPipe pipe(fromStdin ? stdinReader : fileReader, lineNumber);
+		status = ProgFromPipe(pipe, lineNumber);
+	}
+	else if( fromStdin )
+		status = ProgFromReader(stdinReader, lineNumber);
+	else
+		status = ProgFromTree(source, lineNumber, astFile);
+
+    SetTokenCache(NULL);
+    SetChunkLexer(NULL);
+    SetParseEngine(ENGINE_RD);
+    SetErrorColumns(NULL);
+    if( fileFd >= 0 )
+		close(fileFd);
+    
+    if( ProfileOn && !ProfWriteReport(fileName) )
+	{
+		cerr << "CANNOT WRITE PROFILE FOR " << fileName << endl;
+	}
     
     if( !status ){
-    	cout << "\nUnsuccessful Interpretation " << endl << "Number of Errors " << ErrCount()  << endl;
+    	cout << "\nUnsuccessful Interpretation " << endl << "Number of Errors " << ErrorsReported()  << endl;
 	}
 	else{
 		cout << "\nSuccessful Execution" << endl;
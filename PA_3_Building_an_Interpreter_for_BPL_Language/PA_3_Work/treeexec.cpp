@@ -0,0 +1,530 @@
+/*
+ * treeexec.cpp
+ * Running BPL programs from the shared front end's syntax tree
+ * Programming Assignment 3
+ * Fall 2025
+ *
+ * The whole program is parsed by the front end prog2 uses before any of it
+ * runs. The one-pass interpreter of parserInt.h runs each statement as it
+ * parses it, and its checks and messages are kept: a node makes the checks
+ * its rule made, and when a child fails it adds the message the rule added
+ * on the way out. An error is placed at the token that interpreter had read
+ * last when it found it, which is lexed again from the source only then.
+ * Variables are given slots before the run instead of being looked up by
+ * name. A program the front end finds a syntax error in is left to the
+ * one-pass interpreter, since what it prints then depends on how far that
+ * interpreter ran before it got to the error.
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "treeexec.h"
+#include "parserInt.h"
+#include "budget.h"
+#include "profile.h"
+
+namespace {
+
+int errorsReported = 0;
+const LineTable* errorColumns = nullptr;
+
+bool BplTruth(const Value& v) {
+    if (v.IsNum()) return v.GetNum() != 0.0;
+    if (v.IsString()) {
+        const string& s = v.GetString();
+        return !(s == "" || s == "0");
+    }
+    if (v.IsBool()) return v.GetBool();
+    return false;
+}
+
+// MultExpr's test of a string operand of '%' and '.x.'
+bool IsNumeral(const string& s) {
+    try { stod(s); }
+    catch (...) { return false; }
+    return true;
+}
+
+// The leaf a statement or expression starts with, parentheses aside
+uint32_t FirstLeaf(const Ast& ast, uint32_t n) {
+    while (ast[n].kind == N_BINARY || ast[n].kind == N_ASSIGN) n = ast[n].first;
+    return n;
+}
+
+// What the rule of op added when its right operand failed
+const char* MissingOperand(Token op) {
+    switch (op) {
+        case OR:        return "Missing operand for ||";
+        case AND:       return "Missing operand for &&";
+        case PLUS:
+        case MINUS:
+        case CAT:       return "Missing operand for + or - or .";
+        case MULT:
+        case DIV:
+        case REM:
+        case SREPEAT:   return "Missing operand for multiplicative operator";
+        case EXPONENT:  return "Missing exponent operand";
+        default:        return "Missing relational operand";
+    }
+}
+
+} // namespace
+
+TreeRun::TreeRun(const Ast& ast, const SourceBuffer& src)
+    : ast(ast), src(src), text(src.Begin()), slotOf(ast.Size()), trace(nullptr),
+      errLine(0), errOffset(TokenView::NoOffset) {
+    for (uint32_t n = 0; n < ast.Size(); n++)
+        if (ast[n].kind == N_IDENT)
+            slotOf[n] = slots.try_emplace(ast.Text(n, text), uint32_t(slots.size())).first->second;
+    vars.resize(slots.size());
+    assigned.resize(slots.size());
+}
+
+// The error is at the token skip tokens past the one that starts at
+// offset, or that follows a token ending there, on the line the table gives
+// it. No ERR token comes before a statement that runs, so none has taken a
+// newline along that the lexer would not count.
+void TreeRun::Place(size_t offset, unsigned skip) {
+    SourceCursor in(text + offset, src.End());
+    in.beg = text;
+    TokenView t;
+    for (unsigned i = 0; i <= skip; i++) {
+        t = getNextToken(in);
+        if (t == DONE) break;
+    }
+    const LineTable* lines = src.Lines();
+    errLine = lines ? lines->Line(t.offset) : 1 + int(count(text, text + t.offset, '\n'));
+    errOffset = t.offset;
+}
+
+void TreeRun::At(uint32_t n) {
+    Place(ast[n].offset, 0);
+}
+
+// The token after the last one of n is skip tokens past offset: n ends
+// with its last leaf and the ')' of every node between them; the
+// parentheses around n are not its own
+void TreeRun::End(uint32_t n, size_t& offset, unsigned& skip) const {
+    while (ast[n].first != Ast::NoNode) {
+        n = ast[n].first;
+        while (ast[n].next != Ast::NoNode) n = ast[n].next;
+        skip += ast[n].parens;
+    }
+    offset = ast[n].offset + ast[n].length + (ast[n].kind == N_SCONST ? 2 : 0);
+}
+
+// The first token written for n, its outermost '(' if it has one, is skip
+// tokens past offset. It follows the token its parent starts it after.
+void TreeRun::Start(uint32_t n, size_t& offset, unsigned& skip) const {
+    uint32_t p = 0, prev = Ast::NoNode;
+    for (; p < ast.Size(); p++) {
+        prev = Ast::NoNode;
+        uint32_t c = ast[p].first;
+        for (; c != Ast::NoNode && c != n; c = ast[c].next) prev = c;
+        if (c == n) break;
+    }
+
+    switch (ast[p].kind) {
+        case N_BINARY:
+            if (prev == Ast::NoNode) {
+                Start(p, offset, skip);
+                skip += ast[p].parens;
+                return;
+            }
+            // the right operand follows the operator
+            [[fallthrough]];
+        case N_ASSIGN:
+        case N_UNARY:
+            offset = ast[p].offset;
+            skip = 1;
+            return;
+        case N_PRINTLN:
+            if (prev != Ast::NoNode) {
+                skip = 0;
+                End(prev, offset, skip);
+                skip++;     // past the ','
+                return;
+            }
+            // the first expression follows '('
+            [[fallthrough]];
+        default:
+            offset = ast[p].offset;
+            skip = 2;
+            return;
+    }
+}
+
+void TreeRun::After(uint32_t n, unsigned skip) {
+    size_t offset;
+    End(n, offset, skip);
+    Place(offset, skip);
+}
+
+bool TreeRun::Fail(const string& msg) {
+    ReportError(errLine, errOffset, msg);
+    return false;
+}
+
+// A Value operation that failed may have been refused by the budget
+bool TreeRun::OpFail(const string& msg) {
+    if (BudgetError) {
+        const char* budget = BudgetError;
+        BudgetError = nullptr;
+        return Fail(budget);
+    }
+    return Fail(msg);
+}
+
+bool TreeRun::Block(uint32_t n) {
+    for (uint32_t s = ast[n].first; s != Ast::NoNode; s = ast[s].next)
+        if (!Stmt(s)) return false;
+    return true;
+}
+
+bool TreeRun::Stmt(uint32_t n) {
+    uint32_t first = FirstLeaf(ast, n);
+    if (!ChargeOp()) {
+        At(first);
+        return Fail(OpsBudgetMsg);
+    }
+
+    int line = 0;
+    if (ProfileOn) {
+        At(first);
+        line = errLine;
+    }
+    ProfScope prof(Token(ast[first].op), line);
+
+    switch (ast[n].kind) {
+        case N_PRINTLN: return PrintLn(n);
+        case N_IF:      return If(n);
+        case N_ASSIGN:  return Assign(n);
+        default:        return false;
+    }
+}
+
+bool TreeRun::PrintLn(uint32_t n) {
+    printed.clear();
+    for (uint32_t e = ast[n].first; e != Ast::NoNode; e = ast[e].next) {
+        printed.emplace_back();
+        if (!Eval(e, printed.back())) return Fail("Invalid expression list in PrintLn");
+    }
+
+    if (Budget.maxOutput) {
+        ostringstream line;
+        for (const Value& v : printed) line << v;
+        OutputBytes += line.str().size() + 1;
+        if (OutputBytes > Budget.maxOutput) {
+            After(n);
+            return Fail(OutputBudgetMsg);
+        }
+        cout << line.str() << '\n';
+        return true;
+    }
+
+    for (const Value& v : printed) cout << v;
+    cout << '\n';
+    return true;
+}
+
+bool TreeRun::If(uint32_t n) {
+    uint32_t cond = ast[n].first;
+    uint32_t then = ast[cond].next;
+    uint32_t other = ast[then].next;
+
+    Value c;
+    if (!Eval(cond, c)) return Fail("Invalid If condition");
+    if (BplTruth(c)) return Block(then);
+    return other == Ast::NoNode || Block(other);
+}
+
+bool TreeRun::Assign(uint32_t n) {
+    uint32_t var = ast[n].first;
+    uint32_t slot = slotOf[var];
+    Token op = Token(ast[n].op);
+
+    Value rval;
+    if (!Eval(ast[var].next, rval)) return Fail("Missing Expression in Assignment");
+
+    if (trace && op != ASSOP) trace->reads.emplace(ast.Text(var, text));
+
+    Value ans;
+    if (op == ASSOP) {
+        if (rval.IsBool()) {
+            After(n);
+            return Fail("Run-Time Error-Illegal assignment of Boolean");
+        }
+        ans = move(rval);
+    }
+    else {
+        if (!assigned[slot]) {
+            After(n);
+            return Fail("Using Undefined Variable: " + string(ast.Text(var, text)));
+        }
+        ans = op == CADDA ? vars[slot] + rval :
+              op == CSUBA ? vars[slot] - rval :
+                            vars[slot].Catenate(rval);
+        if (ProfileOn && op == CCATA && ans.IsString()) ProfAddBytes(ans.GetString().size());
+    }
+
+    if (ans.IsErr()) {
+        After(n);
+        return OpFail("Run-Time Error-Illegal Assignment Operation");
+    }
+
+    if (Budget.maxMemory) {
+        unsigned long long held = HeldBytes + ans.StringSize() - vars[slot].StringSize();
+        if (held > Budget.maxMemory) {
+            After(n);
+            return Fail(MemoryBudgetMsg);
+        }
+        HeldBytes = held;
+    }
+
+    vars[slot] = move(ans);
+    assigned[slot] = true;
+    if (trace) trace->writes.emplace(ast.Text(var, text));
+    return true;
+}
+
+bool TreeRun::Eval(uint32_t n, Value& v) {
+    const AstNode& a = ast[n];
+    // a parenthesized expression was an operand of its own, charged at '('
+    for (unsigned i = 0; i < a.parens; i++) {
+        if (!ChargeOp()) {
+            size_t offset;
+            unsigned skip;
+            Start(n, offset, skip);
+            Place(offset, skip + i);
+            return Fail(OpsBudgetMsg);
+        }
+    }
+    if (a.kind != N_UNARY && a.kind != N_BINARY && !ChargeOp()) {
+        At(n);
+        return Fail(OpsBudgetMsg);
+    }
+
+    switch (a.kind) {
+        case N_ICONST:
+        case N_FCONST:
+            v = Value(a.value);
+            return true;
+        case N_SCONST:
+            v = Value(string(ast.Text(n, text)));
+            if (ProfileOn) ProfAddBytes(a.length);
+            return true;
+        case N_IDENT: {
+            if (trace) trace->reads.emplace(ast.Text(n, text));
+            uint32_t slot = slotOf[n];
+            if (!assigned[slot]) {
+                At(n);
+                return Fail("Using Undefined Variable: " + string(ast.Text(n, text)));
+            }
+            v = vars[slot];
+            return true;
+        }
+        case N_UNARY:   return Unary(n, v);
+        case N_BINARY:  return Binary(n, v);
+        default:        return false;
+    }
+}
+
+bool TreeRun::Unary(uint32_t n, Value& v) {
+    Token op = Token(ast[n].op);
+    uint32_t x = ast[n].first;
+    // a string constant right after '-' is refused before it is read, so
+    // the profile does not count its bytes
+    if (op == MINUS && ast[x].kind == N_SCONST && !ast[x].parens) {
+        At(x);
+        return Fail(ChargeOp() ? "Run-Time Error-Illegal operand type for sign operation" : OpsBudgetMsg);
+    }
+    if (!Eval(x, v)) return false;
+
+    if (op == NOT) {
+        Value r = !v;
+        if (r.IsErr()) {
+            After(n);
+            return Fail("Run-Time Error-Illegal NOT operation");
+        }
+        v = move(r);
+    }
+    else if (op == MINUS) {
+        if (!v.IsNum()) {
+            // checked at the operand's token, or at the ')' that closes it
+            if (ast[x].parens) After(x, ast[x].parens - 1);
+            else At(x);
+            return Fail("Run-Time Error-Illegal operand type for sign operation");
+        }
+        v = Value(-v.GetNum());
+    }
+    return true;
+}
+
+bool TreeRun::Binary(uint32_t n, Value& v) {
+    const AstNode& a = ast[n];
+    Token op = Token(a.op);
+
+    if (!Eval(a.first, v)) return false;
+    Value r;
+    if (!Eval(ast[a.first].next, r)) return Fail(MissingOperand(op));
+
+    switch (op) {
+        case OR:
+        case AND:
+            v = op == OR ? v || r : v && r;
+            if (v.IsErr()) {
+                After(n);
+                return Fail(op == OR ? "Run-Time Error-Illegal OR Operation" : "Run-Time Error-Illegal AND Operation");
+            }
+            return true;
+
+        case SEQ:
+        case SLTE:
+        case SGT:
+            if (v.IsString() && r.IsString())
+                v = op == SEQ ? v.SEQ(r) : op == SLTE ? v.SLE(r) : v.SGT(r);
+            else
+                v = Value();
+            if (v.IsErr()) {
+                After(n);
+                return Fail("Illegal Relational operation.");
+            }
+            return true;
+
+        case PLUS:
+        case MINUS:
+        case CAT:
+            if (op != CAT && (!v.IsNum() || !r.IsNum())) {
+                After(n);
+                return Fail("Illegal operand type for the operation.");
+            }
+            v = op == PLUS ? v + r : op == MINUS ? v - r : v.Catenate(r);
+            if (v.IsErr()) {
+                After(n);
+                return OpFail("Run-Time Error-Illegal Additive Operation");
+            }
+            if (ProfileOn && op == CAT) ProfAddBytes(v.GetString().size());
+            return true;
+
+        case MULT:
+        case DIV:
+        case REM:
+        case SREPEAT:
+            if (op == REM && (r.IsString() || (v.IsString() && !IsNumeral(v.GetString())))) {
+                After(n);
+                return Fail("Illegal operand type for the operation.");
+            }
+            if (op == SREPEAT && (r.IsString() ? !IsNumeral(r.GetString()) : !r.IsNum())) {
+                After(n);
+                return Fail("Illegal operand type for the string repetition operation.");
+            }
+            v = op == MULT ? v * r : op == DIV ? v / r : op == REM ? v % r : v.Repeat(r);
+            if (v.IsErr()) {
+                After(n);
+                return OpFail("Run-Time Error-Illegal Multiplicative Operation");
+            }
+            if (ProfileOn && op == SREPEAT) ProfAddBytes(v.GetString().size());
+            return true;
+
+        case EXPONENT:
+            v = v.IsNum() && r.IsNum() ? v.Expon(r) : Value();
+            if (v.IsErr()) {
+                After(n);
+                return Fail("Run-Time Error-Illegal Exponentiation");
+            }
+            return true;
+
+        default: {
+            // RelExpr goes by the lexeme of any other operator, even a
+            // string constant's, whose text starts past its quote
+            string_view lex(text + a.offset + (op == SCONST), a.length);
+            if (v.IsNum() && r.IsNum())
+                v = lex == "<" ? v < r : lex == ">=" ? v >= r : v == r;
+            else
+                v = Value();
+            if (v.IsErr()) {
+                After(n);
+                return Fail("Illegal Relational operation.");
+            }
+            return true;
+        }
+    }
+}
+
+const Value* TreeRun::Get(string_view name) const {
+    auto it = slots.find(name);
+    return it != slots.end() && assigned[it->second] ? &vars[it->second] : nullptr;
+}
+
+void TreeRun::Set(string_view name, const Value& v) {
+    auto it = slots.find(name);
+    if (it == slots.end()) return;
+    uint32_t slot = it->second;
+    HeldBytes = HeldBytes + v.StringSize() - vars[slot].StringSize();
+    vars[slot] = v;
+    assigned[slot] = true;
+}
+
+bool ParseProg(const SourceBuffer& src, int& line, Ast& ast, vector<Diagnostic>& errors) {
+    SourceCursor cursor(src);
+    istream none(nullptr);
+    errorsReported = 0;
+
+    SetTokenSource(&cursor);
+    SetAstOutput(&ast);
+    SetDialect(DIALECT_PROG3);
+    bool ok = CheckProg(none, line, errors);
+    SetDialect(DIALECT_PROG2);
+    SetAstOutput(nullptr);
+    SetTokenSource(nullptr);
+    return ok;
+}
+
+void SetErrorColumns(const LineTable* lines) {
+    errorColumns = lines;
+}
+
+void ReportError(int line, unsigned offset, const string& msg) {
+    ++errorsReported;
+    cout << errorsReported << ". Line " << line;
+    if (errorColumns && offset != TokenView::NoOffset)
+        cout << ", Column " << errorColumns->Column(offset);
+    cout << ": " << msg << endl;
+}
+
+int ErrorsReported() {
+    return errorsReported;
+}
+
+bool FinishProg(bool ok) {
+    if (!ok) {
+        cout << "\nUnsuccessful Interpretation" << endl;
+        cout << "Number of Errors " << errorsReported << endl;
+        return false;
+    }
+    cout << endl << endl;
+    cout << "DONE" << endl;
+    return true;
+}
+
+bool ProgFromTree(const SourceBuffer& src, int& line, const string& treeFile) {
+    Ast ast;
+    if (!treeFile.empty() && ast.Load(treeFile, src, DIALECT_PROG3)) {
+        errorsReported = 0;
+    } else {
+        vector<Diagnostic> errors;
+        int first = line;
+        if (!ParseProg(src, line, ast, errors)) {
+            line = first;
+            return ProgFromSource(src, line);
+        }
+        if (!treeFile.empty() && !ast.Save(treeFile, src, DIALECT_PROG3))
+            cerr << "CANNOT WRITE AST FILE " << treeFile << endl;
+    }
+
+    TreeRun run(ast, src);
+    return FinishProg(run.Block(ast.Root()));
+}
@@ -0,0 +1,105 @@
+/*
+ * treeexec.h
+ * Running BPL programs from the shared front end's syntax tree
+ * Programming Assignment 3
+ * Fall 2025
+*/
+
+#ifndef TREEEXEC_H_
+#define TREEEXEC_H_
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <cstdint>
+
+using namespace std;
+
+#include "lex.h"
+#include "parser.h"
+#include "ast.h"
+#include "val.h"
+
+//Variables read and written by the top-level statement being run
+struct StmtTrace {
+	set<string> reads;
+	set<string> writes;
+};
+
+//Runs statements of a tree parsed from src, printing their output to cout.
+//A run-time error is reported the way prog3 has always reported it: one
+//numbered message where it was found, then one for each rule the
+//interpreter would have failed out of on its way back to the statement,
+//all placed at the same token.
+class TreeRun {
+	const Ast& ast;
+	const SourceBuffer& src;
+	const char* text;
+	vector<uint32_t> slotOf;	// variable slot of each N_IDENT node
+	unordered_map<string_view, uint32_t> slots;
+	vector<Value> vars;
+	vector<bool> assigned;
+	vector<Value> printed;	// a PrintLn's values, kept from one to the next
+	StmtTrace* trace;
+	//where the error being reported was found
+	int errLine;
+	unsigned errOffset;
+
+	bool PrintLn(uint32_t n);
+	bool If(uint32_t n);
+	bool Assign(uint32_t n);
+	bool Eval(uint32_t n, Value& v);
+	bool Unary(uint32_t n, Value& v);
+	bool Binary(uint32_t n, Value& v);
+
+	void Place(size_t offset, unsigned skip);
+	void Start(uint32_t n, size_t& offset, unsigned& skip) const;
+	void End(uint32_t n, size_t& offset, unsigned& skip) const;
+	void At(uint32_t n);
+	void After(uint32_t n, unsigned skip = 0);
+	//Print a message at the place of the error being reported
+	bool Fail(const string& msg);
+	bool OpFail(const string& msg);
+
+public:
+	TreeRun(const Ast& ast, const SourceBuffer& src);
+
+	//False once the statement has reported a run-time error
+	bool Stmt(uint32_t n);
+	bool Block(uint32_t n);
+
+	//Records what the statements run from now on read and write
+	void SetTrace(StmtTrace* t) { trace = t; }
+	//Value of a variable of the program, or null if it has none yet
+	const Value* Get(string_view name) const;
+	//Gives a variable of the program a value, as if it had been assigned
+	void Set(string_view name, const Value& v);
+};
+
+//Parses src in prog3's dialect into ast, taking the tokens from a cursor
+//over src unless a cache or chunk lexer was set in the parser.
+//errors gets the syntax errors; the tree then holds the top-level
+//statements before the first one.
+extern bool ParseProg(const SourceBuffer& src, int& line, Ast& ast, vector<Diagnostic>& errors);
+
+//Columns of error messages come from lines, when it is set
+extern void SetErrorColumns(const LineTable* lines);
+//Prints an error numbered after the messages printed so far, with the
+//column of offset when columns are set
+extern void ReportError(int line, unsigned offset, const string& msg);
+//Messages printed since the last program started
+extern int ErrorsReported();
+//Prints what ends a run, and passes ok on
+extern bool FinishProg(bool ok);
+
+//Parses the program with ParseProg and runs it, or if it has a syntax
+//error runs it with ProgFromSource instead. Prints what prog3 prints for
+//the program. With a tree file, a tree an earlier run saved there from the
+//same source is run without parsing; otherwise the parsed tree is saved
+//there. prog2 -ast trees are in prog2's dialect and are not used.
+extern bool ProgFromTree(const SourceBuffer& src, int& line, const string& treeFile = "");
+
+#endif /* TREEEXEC_H_ */
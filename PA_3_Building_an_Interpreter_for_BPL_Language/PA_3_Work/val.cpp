@@ -1,7 +1,9 @@
 #include "val.h"
+#include "budget.h"
 #include <sstream>
 #include <cmath>
 #include <iomanip>
+#include <new>
 
 static double StringToNum(const string &s) {
     try {
@@ -46,7 +48,7 @@ static bool ToBool(const Value &v) {
     if (v.IsNum()) return v.GetNum() != 0.0;
 
     if (v.IsString()) {
-        string s = v.GetString();
+        const string& s = v.GetString();
         return !(s == "" || s == "0");
     }
 
@@ -115,7 +117,11 @@ Value Value::Expon(const Value& oper) const {
 }
 
 Value Value::Catenate(const Value &op) const {
-    return Value(ToString(*this) + ToString(op));
+    string lhs = ToString(*this);
+    string rhs = ToString(op);
+    if (!StringFits((double)lhs.size() + rhs.size())) return Value();
+    lhs += rhs;
+    return Value(move(lhs));
 }
 
 Value Value::Repeat(const Value &op) const {
@@ -123,17 +129,32 @@ Value Value::Repeat(const Value &op) const {
         return Value();  
 
     double raw = ToNum(op);
-    int n = (int)raw;
+    string base = ToString(*this);
 
-    if (n < 0) return Value();
+    if (raw > 0 && !StringFits((double)base.size() * raw)) return Value();
 
-    string base = ToString(*this);
+    // a fraction of a repetition is dropped; NaN is no count at all
+    double count = trunc(raw);
+    if (!(count >= 0)) return Value();
+    if (base.empty() || count == 0) return Value(string());
+
+    if (count > double(base.max_size() / base.size())) {
+        BudgetError = StringSizeMsg;
+        return Value();
+    }
+    size_t n = size_t(count);
 
-    string out = "";
-    for (int i = 0; i < n; i++)
+    string out;
+    try {
+        out.reserve(base.size() * n);
+    } catch (const bad_alloc&) {
+        BudgetError = StringSizeMsg;
+        return Value();
+    }
+    for (size_t i = 0; i < n; i++)
         out += base;
 
-    return Value(out);
+    return Value(move(out));
 }
 
 Value Value::SEQ(const Value &oper) const {
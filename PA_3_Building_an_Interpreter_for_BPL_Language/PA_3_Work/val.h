@@ -4,6 +4,7 @@
 #include <iostream>
 #include <string>
 #include <queue>
+#include <vector>
 #include <map>
 #include <iomanip>
 #include <stdexcept>
@@ -24,7 +25,7 @@ public:
     Value() : T(VERR), Btemp(false), Ntemp(0.0), Stemp("") {}
     Value(bool vb) : T(VBOOL), Btemp(vb), Ntemp(0.0), Stemp("") {}
     Value(double vr) : T(VNUM), Btemp(false), Ntemp(vr), Stemp("") {}
-    Value(string vs) : T(VSTRING), Btemp(false), Ntemp(0.0), Stemp(vs) {}
+    Value(string vs) : T(VSTRING), Btemp(false), Ntemp(0.0), Stemp(move(vs)) {}
 
     ValType GetType() const { return T; }
     bool IsErr() const { return T == VERR; }
@@ -32,7 +33,7 @@ public:
     bool IsNum() const { return T == VNUM; }
     bool IsBool() const { return T == VBOOL; }
 
-    string GetString() const {
+    const string& GetString() const {
         if (IsString()) return Stemp;
         throw "RUNTIME ERROR: Value not a string";
     }
@@ -42,6 +43,8 @@ public:
         throw "RUNTIME ERROR: Value not a number";
     }
 
+    size_t StringSize() const { return IsString() ? Stemp.size() : 0; }
+
     bool GetBool() const {
         if (IsBool()) return Btemp;
         throw "RUNTIME ERROR: Value not a boolean";
@@ -49,7 +52,7 @@ public:
 
     void SetType(ValType type) { T = type; }
     void SetNum(double val) { Ntemp = val; }
-    void SetString(string val) { Stemp = val; }
+    void SetString(string val) { Stemp = move(val); }
     void SetBool(bool val) { Btemp = val; }
 
     // Numeric operations